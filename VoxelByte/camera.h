@@ -108,6 +108,14 @@ public:
         updateCameraVectors();
     }
 
+    // Sets the Euler angles directly, e.g. for scripted camera paths
+    void SetOrientation(float yaw, float pitch)
+    {
+        Yaw = yaw;
+        Pitch = pitch;
+        updateCameraVectors();
+    }
+
     // Processes input received from a mouse scroll-wheel event. Only requires input on the vertical wheel-axis
     void ProcessMouseScroll(float yoffset)
     {
@@ -0,0 +1,403 @@
+#include "globals.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VB_CODEC_SSE
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+static const size_t CHUNK_VOLUME = Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE;
+static const size_t SECTION_VOLUME = Chunk::SECTION_SIZE * Chunk::SECTION_SIZE * Chunk::SECTION_SIZE;
+// One section thick in x, the whole chunk in y and z
+static const size_t SLAB_VOLUME = Chunk::SECTION_SIZE * Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE;
+
+// Every run is at least an id and one varint byte, so no valid chunk has more run bytes than this
+static const size_t MAX_RUN_BYTES = 2 * CHUNK_VOLUME;
+
+static const size_t LZ_MIN_MATCH = 4;
+static const size_t LZ_MAX_OFFSET = 65535;
+static const int LZ_HASH_BITS = 12;
+
+static uint64_t nanoseconds_since(std::chrono::steady_clock::time_point start)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+static void write_varint(std::vector<uint8_t>& out, size_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool read_varint(const uint8_t*& data, const uint8_t* end, size_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        if (data == end) return false;
+        uint8_t byte = *data++;
+        value |= static_cast<size_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+// How many of the first count bytes of in are id
+static size_t run_length(const uint8_t* in, size_t count, uint8_t id)
+{
+    size_t n = 0;
+#ifdef VB_CODEC_SSE
+    // 16 ids per compare, the first mismatch is the lowest clear bit of the mask
+    const __m128i ids = _mm_set1_epi8(static_cast<char>(id));
+    for (; n + 16 <= count; n += 16)
+    {
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + n)), ids)));
+        if (mask == 0xffff) continue;
+#if defined(_MSC_VER)
+        unsigned long first;
+        _BitScanForward(&first, ~mask);
+        return n + first;
+#else
+        return n + static_cast<size_t>(__builtin_ctz(~mask));
+#endif
+    }
+#endif
+    while (n < count && in[n] == id) n++;
+    return n;
+}
+
+static void append_run(std::vector<uint8_t>& out, uint8_t id, size_t length)
+{
+    out.push_back(id);
+    write_varint(out, length - 1);
+}
+
+// Length of an LZ token field past its 4 bit nibble, 255 per byte until a smaller one
+static void write_lz_length(std::vector<uint8_t>& out, size_t length)
+{
+    for (; length >= 255; length -= 255) out.push_back(255);
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+static bool read_lz_length(const uint8_t*& data, const uint8_t* end, size_t& length)
+{
+    uint8_t byte;
+    do
+    {
+        if (data == end) return false;
+        byte = *data++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+static void write_lz_sequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literal_count, size_t offset, size_t match_length)
+{
+    size_t match_field = match_length > 0 ? match_length - LZ_MIN_MATCH : 0;
+    out.push_back(static_cast<uint8_t>((std::min<size_t>(literal_count, 15) << 4) | std::min<size_t>(match_field, 15)));
+    if (literal_count >= 15) write_lz_length(out, literal_count - 15);
+    out.insert(out.end(), literals, literals + literal_count);
+
+    // The last sequence is literals only, the decoder knows it's last because the input ends there
+    if (match_length == 0) return;
+    out.push_back(static_cast<uint8_t>(offset));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (match_field >= 15) write_lz_length(out, match_field - 15);
+}
+
+// ----------<[ CHUNKCODEC CLASS IMPLEMENTATION ]>----------
+ChunkCodec::ChunkCodec()
+{
+    VB::inst().GetLogger()->Print(std::string("ChunkCodec obj constructed, run detection uses ") + GetSimdName());
+}
+
+void ChunkCodec::Encode(const Chunk& chunk, std::vector<uint8_t>& out, bool lz)
+{
+    if (!lz)
+    {
+        encode_runs(chunk, out);
+        return;
+    }
+
+    std::vector<uint8_t> runs;
+    encode_runs(chunk, runs);
+    write_varint(out, runs.size());
+    lz_compress(runs.data(), runs.size(), out);
+}
+
+bool ChunkCodec::Decode(const uint8_t* data, size_t size, bool lz, Chunk& chunk)
+{
+    if (!lz) return decode_runs(data, size, chunk);
+
+    const uint8_t* end = data + size;
+    size_t run_bytes;
+    if (!read_varint(data, end, run_bytes) || run_bytes > MAX_RUN_BYTES) return false;
+
+    std::vector<uint8_t> runs(run_bytes);
+    if (!lz_decompress(data, end - data, runs.data(), runs.size())) return false;
+    return decode_runs(runs.data(), runs.size(), chunk);
+}
+
+const char* ChunkCodec::GetSimdName()
+{
+#ifdef VB_CODEC_SSE
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+const ChunkCodec::BenchmarkResult& ChunkCodec::RunBenchmark(int chunks_per_axis, int repeats)
+{
+    BenchmarkResult result;
+    result.valid = true;
+    result.repeats = std::max(repeats, 1);
+
+    // Same block as the region benchmark, it straddles the surface so it holds air, ground and everything between
+    const glm::ivec3 base_idx(4096, -2, 4096);
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    for (int x = 0; x < chunks_per_axis; x++)
+    for (int y = 0; y < chunks_per_axis; y++)
+    for (int z = 0; z < chunks_per_axis; z++)
+    {
+        glm::ivec3 chunk_idx = base_idx + glm::ivec3(x, y, z);
+        chunks.push_back(std::make_unique<Chunk>(PackChunkID(chunk_idx), chunk_idx * Chunk::CHUNK_SIZE));
+        chunks.back()->GenerateChunk();
+    }
+
+    Chunk decoded(PackChunkID(base_idx), base_idx * Chunk::CHUNK_SIZE);
+    std::vector<uint8_t> encoded;
+    for (const std::unique_ptr<Chunk>& chunk : chunks)
+    {
+        uint64_t hash = chunk->GetContentHash();
+
+        encoded.clear();
+        chunk->Serialize(encoded, Chunk::CHUNK_FORMAT_SECTIONS);
+        result.section_bytes += encoded.size();
+
+        for (bool lz : { false, true })
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < result.repeats; r++)
+            {
+                encoded.clear();
+                Encode(*chunk, encoded, lz);
+            }
+            (lz ? result.lz_encode_seconds : result.run_encode_seconds) += nanoseconds_since(start) * 1e-9;
+            (lz ? result.lz_bytes : result.run_bytes) += encoded.size();
+
+            bool decoded_ok = true;
+            start = std::chrono::steady_clock::now();
+            for (int r = 0; r < result.repeats; r++) decoded_ok &= Decode(encoded.data(), encoded.size(), lz, decoded);
+            (lz ? result.lz_decode_seconds : result.run_decode_seconds) += nanoseconds_since(start) * 1e-9;
+
+            if (!decoded_ok || decoded.GetContentHash() != hash) result.mismatched_chunks++;
+        }
+
+        result.raw_bytes += CHUNK_VOLUME;
+        result.chunks++;
+    }
+
+    m_last_benchmark = result;
+    VB::inst().GetLogger()->Print("Codec benchmark: " + std::to_string(result.chunks) + " chunks, runs " + std::to_string(result.run_bytes) +
+                                  " bytes, lz " + std::to_string(result.lz_bytes) + " bytes, " + std::to_string(result.mismatched_chunks) + " mismatched");
+    return m_last_benchmark;
+}
+
+const ChunkCodec::BenchmarkResult& ChunkCodec::GetLastBenchmark() const
+{
+    return m_last_benchmark;
+}
+
+void ChunkCodec::encode_runs(const Chunk& chunk, std::vector<uint8_t>& out)
+{
+    const int S = Chunk::SECTION_SIZE;
+    const int N = Chunk::CHUNK_SIZE;
+
+    uint8_t uniform_id;
+    if (chunk.IsUniform() && chunk.IsSectionUniform(glm::ivec3(0), uniform_id))
+    {
+        append_run(out, uniform_id, CHUNK_VOLUME);
+        return;
+    }
+
+    // The run in progress carries over from one slab to the next
+    std::vector<uint8_t> slab(SLAB_VOLUME);
+    uint8_t section_ids[SECTION_VOLUME];
+    uint8_t run_id = 0;
+    size_t run = 0;
+    for (int sx = 0; sx < Chunk::SECTIONS_PER_AXIS; sx++)
+    {
+        for (int sy = 0; sy < Chunk::SECTIONS_PER_AXIS; sy++)
+        for (int sz = 0; sz < Chunk::SECTIONS_PER_AXIS; sz++)
+        {
+            glm::ivec3 section(sx, sy, sz);
+            bool uniform = chunk.IsSectionUniform(section, uniform_id);
+            if (!uniform) chunk.CopySection(section, section_ids);
+
+            for (int x = 0; x < S; x++)
+            for (int y = 0; y < S; y++)
+            {
+                uint8_t* row = slab.data() + x * N * N + (sy * S + y) * N + sz * S;
+                if (uniform) std::memset(row, uniform_id, S);
+                else std::memcpy(row, section_ids + x * S * S + y * S, S);
+            }
+        }
+
+        for (size_t pos = 0; ; )
+        {
+            size_t length = run_length(slab.data() + pos, SLAB_VOLUME - pos, run_id);
+            run += length;
+            pos += length;
+            if (pos == SLAB_VOLUME) break;
+
+            // Only the very first id of the chunk can start with nothing to flush
+            if (run > 0) append_run(out, run_id, run);
+            run_id = slab[pos];
+            run = 0;
+        }
+    }
+
+    append_run(out, run_id, run);
+}
+
+bool ChunkCodec::decode_runs(const uint8_t* data, size_t size, Chunk& chunk)
+{
+    const int S = Chunk::SECTION_SIZE;
+    const int N = Chunk::CHUNK_SIZE;
+    const uint8_t* end = data + size;
+
+    // Check the whole stream first so a bad one can't leave the chunk half written
+    size_t total = 0;
+    size_t run_count = 0;
+    for (const uint8_t* p = data; p != end; run_count++)
+    {
+        size_t length;
+        p++;
+        if (!read_varint(p, end, length)) return false;
+        total += length + 1;
+        if (total > CHUNK_VOLUME) return false;
+    }
+    if (total != CHUNK_VOLUME) return false;
+
+    if (run_count == 1)
+    {
+        chunk.Fill(data[0]);
+        return true;
+    }
+
+    std::vector<uint8_t> slab(SLAB_VOLUME);
+    uint8_t section_ids[SECTION_VOLUME];
+    uint8_t run_id = 0;
+    size_t remaining = 0;
+    for (int sx = 0; sx < Chunk::SECTIONS_PER_AXIS; sx++)
+    {
+        for (size_t filled = 0; filled < SLAB_VOLUME; )
+        {
+            if (remaining == 0)
+            {
+                run_id = *data++;
+                read_varint(data, end, remaining);
+                remaining++;
+            }
+
+            size_t count = std::min(remaining, SLAB_VOLUME - filled);
+            std::memset(slab.data() + filled, run_id, count);
+            filled += count;
+            remaining -= count;
+        }
+
+        for (int sy = 0; sy < Chunk::SECTIONS_PER_AXIS; sy++)
+        for (int sz = 0; sz < Chunk::SECTIONS_PER_AXIS; sz++)
+        {
+            for (int x = 0; x < S; x++)
+            for (int y = 0; y < S; y++)
+                std::memcpy(section_ids + x * S * S + y * S, slab.data() + x * N * N + (sy * S + y) * N + sz * S, S);
+
+            chunk.SetSection(glm::ivec3(sx, sy, sz), section_ids);
+        }
+    }
+
+    return true;
+}
+
+void ChunkCodec::lz_compress(const uint8_t* in, size_t size, std::vector<uint8_t>& out)
+{
+    // Most recent position of each hashed 4 byte sequence, plus one so zero means none
+    std::vector<uint32_t> table(size_t(1) << LZ_HASH_BITS, 0);
+
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + LZ_MIN_MATCH <= size)
+    {
+        uint32_t sequence;
+        std::memcpy(&sequence, in + pos, sizeof(sequence));
+        uint32_t hash = (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+        size_t candidate = table[hash];
+        table[hash] = static_cast<uint32_t>(pos + 1);
+
+        uint32_t candidate_sequence = 0;
+        if (candidate > 0) std::memcpy(&candidate_sequence, in + candidate - 1, sizeof(candidate_sequence));
+        if (candidate == 0 || pos + 1 - candidate > LZ_MAX_OFFSET || candidate_sequence != sequence)
+        {
+            // Step further the longer nothing has matched, incompressible stretches go by quickly
+            pos += 1 + ((pos - anchor) >> 6);
+            continue;
+        }
+
+        candidate--;
+        size_t length = LZ_MIN_MATCH;
+        while (pos + length < size && in[candidate + length] == in[pos + length]) length++;
+
+        write_lz_sequence(out, in + anchor, pos - anchor, pos - candidate, length);
+        pos += length;
+        anchor = pos;
+    }
+
+    write_lz_sequence(out, in + anchor, size - anchor, 0, 0);
+}
+
+bool ChunkCodec::lz_decompress(const uint8_t* in, size_t size, uint8_t* out, size_t out_size)
+{
+    const uint8_t* end = in + size;
+    size_t written = 0;
+    while (true)
+    {
+        // The stream always ends on a literals only sequence, even an empty one, so running out of input
+        //   right after a match means it was cut short
+        if (in == end) return false;
+        uint8_t token = *in++;
+
+        size_t literal_count = token >> 4;
+        if (literal_count == 15 && !read_lz_length(in, end, literal_count)) return false;
+        if (literal_count > static_cast<size_t>(end - in) || literal_count > out_size - written) return false;
+        std::memcpy(out + written, in, literal_count);
+        in += literal_count;
+        written += literal_count;
+        if (in == end) return written == out_size;
+
+        if (end - in < 2) return false;
+        size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        size_t match_length = token & 15;
+        if (match_length == 15 && !read_lz_length(in, end, match_length)) return false;
+        match_length += LZ_MIN_MATCH;
+        if (offset == 0 || offset > written || match_length > out_size - written) return false;
+
+        // Matches may overlap what they produce (a run of one repeated byte has offset 1), so copy forwards
+        const uint8_t* match = out + written - offset;
+        if (offset >= match_length) std::memcpy(out + written, match, match_length);
+        else for (size_t i = 0; i < match_length; i++) out[written + i] = match[i];
+        written += match_length;
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef CHUNK_CODEC_H
+#define CHUNK_CODEC_H
+
+#include "voxel.h"
+
+#include <cstdint>
+#include <vector>
+
+// Compact chunk encoding for saving (and anything else that has to move chunks around as bytes).
+//   runs  the voxels in x * 4096 + y * 64 + z order, z being contiguous, as (id, varint length - 1)
+//         pairs. Runs carry on across rows, so a layer of air or stone is a single run.
+//   lz    an optional LZ4 style pass over the runs: literal/match length tokens and 16-bit offsets,
+//         which catches rows that repeat the same pattern of runs
+// Encoding reads the chunk one 16 voxel slab of x at a time through CopySection and decoding writes it
+//   back through SetSection, neither goes through a dense copy of the whole chunk.
+class ChunkCodec
+{
+public:
+    ChunkCodec();
+
+    // Appends the chunk's runs, LZ compressed if lz is set, to out
+    static void Encode(const Chunk& chunk, std::vector<uint8_t>& out, bool lz);
+    // Replaces the chunk's voxels with what Encode wrote. Returns false, leaving the chunk as it was, if
+    //   the bytes don't decode to exactly one chunk.
+    static bool Decode(const uint8_t* data, size_t size, bool lz, Chunk& chunk);
+
+    static const char* GetSimdName();
+
+    struct BenchmarkResult
+    {
+        bool valid = false;
+        size_t chunks = 0;
+        int repeats = 0;
+        size_t raw_bytes = 0;
+        // Chunk::CHUNK_FORMAT_SECTIONS payloads, for comparison
+        size_t section_bytes = 0;
+        size_t run_bytes = 0;
+        size_t lz_bytes = 0;
+        double run_encode_seconds = 0.0;
+        double run_decode_seconds = 0.0;
+        double lz_encode_seconds = 0.0;
+        double lz_decode_seconds = 0.0;
+        // Chunks that came back with a different content hash
+        size_t mismatched_chunks = 0;
+    };
+    // Generates a block of chunks away from the loaded world, then encodes and decodes each one repeats
+    //   times both ways on the calling thread. Throughput is in raw chunk bytes.
+    const BenchmarkResult& RunBenchmark(int chunks_per_axis = 4, int repeats = 8);
+    const BenchmarkResult& GetLastBenchmark() const;
+
+private:
+    BenchmarkResult m_last_benchmark;
+
+    static void encode_runs(const Chunk& chunk, std::vector<uint8_t>& out);
+    static bool decode_runs(const uint8_t* data, size_t size, Chunk& chunk);
+    static void lz_compress(const uint8_t* in, size_t size, std::vector<uint8_t>& out);
+    static bool lz_decompress(const uint8_t* in, size_t size, uint8_t* out, size_t out_size);
+};
+
+#endif
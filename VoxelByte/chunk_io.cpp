@@ -0,0 +1,182 @@
+#include "globals.h"
+
+#include <algorithm>
+#include <chrono>
+
+// ----------<[ CHUNKIOSERVICE CLASS IMPLEMENTATION ]>----------
+ChunkIOService::ChunkIOService()
+{
+    m_thread = std::thread(&ChunkIOService::io_loop, this);
+    VB::inst().GetLogger()->Print("ChunkIOService obj constructed");
+}
+
+ChunkIOService::~ChunkIOService()
+{
+    Shutdown();
+}
+
+void ChunkIOService::QueueSave(std::unique_ptr<Chunk> chunk)
+{
+    chunk->ClearDirty();
+    ChunkID chunk_id = chunk->GetChunkID();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+
+        QueuedChunk& queued = m_pending[chunk_id];
+        if (queued != nullptr) m_stats.coalesced++;
+        queued = std::move(chunk);
+        m_stats.queued++;
+    }
+    m_queue_cv.notify_one();
+}
+
+bool ChunkIOService::LoadChunk(Chunk& chunk)
+{
+    QueuedChunk queued_chunk;
+    {
+        // A chunk evicted and then loaded again before its save lands has to come back as it was saved
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const QueuedChunk* queued = m_pending.Find(chunk.GetChunkID());
+        if (queued == nullptr) queued = m_writing.Find(chunk.GetChunkID());
+        if (queued != nullptr) queued_chunk = *queued;
+    }
+
+    if (queued_chunk == nullptr) return VB::inst().GetRegionStore()->LoadChunk(chunk);
+    chunk = *queued_chunk;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.loaded_from_queue++;
+    return true;
+}
+
+void ChunkIOService::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable()) return;
+
+    m_flush_requested = true;
+    m_queue_cv.notify_one();
+    m_flushed_cv.wait(lock, [this] { return m_pending.Empty() && m_writing.Empty(); });
+    m_flush_requested = false;
+}
+
+void ChunkIOService::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+        m_stopping = true;
+    }
+    m_queue_cv.notify_one();
+
+    // The thread drains the queue before it exits
+    if (m_thread.joinable()) m_thread.join();
+}
+
+ChunkIOService::Stats ChunkIOService::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.pending = m_pending.Size() + m_writing.Size();
+    return stats;
+}
+
+void ChunkIOService::io_loop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_queue_cv.wait(lock, [this] { return m_stopping || !m_pending.Empty(); });
+        if (m_pending.Empty()) return;
+
+        // Give the batch time to collect more saves, cut short by a flush or shutdown
+        m_queue_cv.wait_for(lock, std::chrono::milliseconds(BATCH_DELAY_MS), [this] { return m_stopping || m_flush_requested; });
+
+        std::swap(m_pending, m_writing);
+        lock.unlock();
+        write_batch(m_writing);
+        lock.lock();
+
+        m_writing.Clear();
+        m_stats.batches++;
+        if (m_pending.Empty()) m_flushed_cv.notify_all();
+    }
+}
+
+void ChunkIOService::write_batch(const ChunkMap<QueuedChunk>& batch)
+{
+    struct QueuedWrite
+    {
+        ChunkID chunk_id;
+        ChunkID region_key;
+        glm::ivec3 region_idx;
+        int slot;
+        const QueuedChunk* chunk;
+        std::vector<uint8_t> payload;
+        bool failed;
+    };
+
+    // m_writing isn't changed by anyone else until this returns, so its chunks can be used without the lock. Loads
+    //   only read them, which is why encoding them here is safe.
+    std::vector<QueuedWrite> writes;
+    writes.reserve(batch.Size());
+    for (const auto& queued : batch)
+    {
+        glm::ivec3 chunk_idx = UnpackChunkID(queued.first);
+        glm::ivec3 region_idx = RegionStore::ChunkToRegionIdx(chunk_idx);
+        writes.push_back({ queued.first, PackChunkID(region_idx), region_idx, RegionStore::ChunkToRegionSlot(chunk_idx), &queued.second, {}, false });
+        queued.second->Serialize(writes.back().payload);
+    }
+
+    // One run per region file, in slot order
+    std::sort(writes.begin(), writes.end(), [](const QueuedWrite& a, const QueuedWrite& b)
+    {
+        return a.region_key != b.region_key ? a.region_key < b.region_key : a.slot < b.slot;
+    });
+
+    size_t written = 0, failed = 0, region_writes = 0;
+    std::vector<RegionFile::SlotWrite> region_batch;
+    for (size_t begin = 0; begin < writes.size(); )
+    {
+        size_t end = begin;
+        region_batch.clear();
+        for (; end < writes.size() && writes[end].region_key == writes[begin].region_key; end++)
+            region_batch.push_back({ writes[end].slot, writes[end].payload.data(), writes[end].payload.size() });
+
+        // A failed write has already been logged, the slots still hold what was saved before
+        if (VB::inst().GetRegionStore()->WriteChunks(writes[begin].region_idx, region_batch)) written += region_batch.size();
+        else for (size_t i = begin; i < end; i++, failed++) writes[i].failed = true;
+        region_writes++;
+        begin = end;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.written += written;
+    m_stats.failed += failed;
+    m_stats.region_writes += region_writes;
+    if (failed == 0 && m_write_attempts.Empty()) return;
+
+    // The loaded chunk's dirty flag was cleared when it was queued, or it's been evicted, so a chunk that didn't
+    //   make it goes back into the queue (to be encoded again) rather than being lost
+    for (const QueuedWrite& write : writes)
+    {
+        if (!write.failed || m_pending.Contains(write.chunk_id))
+        {
+            m_write_attempts.Erase(write.chunk_id);
+            continue;
+        }
+
+        int& attempts = m_write_attempts[write.chunk_id];
+        if (++attempts >= MAX_WRITE_ATTEMPTS)
+        {
+            VB::inst().GetLogger()->PrintErr("Dropping save of chunk " + std::to_string(write.chunk_id) + " after " +
+                                             std::to_string(attempts) + " failed writes");
+            m_write_attempts.Erase(write.chunk_id);
+            m_stats.dropped++;
+            continue;
+        }
+        m_pending[write.chunk_id] = *write.chunk;
+    }
+}
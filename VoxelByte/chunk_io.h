@@ -0,0 +1,80 @@
+#ifndef CHUNK_IO_H
+#define CHUNK_IO_H
+
+#include "voxel.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Write-behind saving on a dedicated thread, so evicting or editing a chunk never waits on the disk.
+//   QueueSave takes the chunk itself and returns, serializing it is left to the thread. Chunks wait up to
+//   BATCH_DELAY_MS so that saving the same chunk again only replaces the queued one, then the thread
+//   encodes and writes them out grouped by region file, opening each file once per batch. Loads check the
+//   chunks that haven't reached the disk yet before reading the region files. A chunk whose write fails
+//   goes back into the queue for the next batch, unless a newer save replaced it, and is dropped (and
+//   logged) after MAX_WRITE_ATTEMPTS failed writes.
+class ChunkIOService
+{
+public:
+    static constexpr int BATCH_DELAY_MS = 250;
+    static constexpr int MAX_WRITE_ATTEMPTS = 3;
+
+    ChunkIOService();
+    ~ChunkIOService();
+
+    // Takes over the chunk, which is serialized on the I/O thread. A chunk that stays loaded is saved by
+    //   queueing a copy of it.
+    void QueueSave(std::unique_ptr<Chunk> chunk);
+    // Fills chunk from its queued payload or from disk, returns true if it was saved before
+    bool LoadChunk(Chunk& chunk);
+    // Blocks until everything queued so far is written
+    void Flush();
+    // Flushes and stops the I/O thread, saves queued afterwards are dropped
+    void Shutdown();
+
+    struct Stats
+    {
+        size_t queued = 0;
+        // Saves that replaced a chunk still waiting to be written
+        size_t coalesced = 0;
+        size_t written = 0;
+        // Failed writes, each retried in the next batch until MAX_WRITE_ATTEMPTS
+        size_t failed = 0;
+        // Saves given up on after MAX_WRITE_ATTEMPTS failed writes
+        size_t dropped = 0;
+        size_t batches = 0;
+        size_t region_writes = 0;
+        size_t pending = 0;
+        size_t loaded_from_queue = 0;
+    };
+    Stats GetStats() const;
+
+private:
+    // Never changed once queued, so loads can copy from it while the thread encodes it
+    typedef std::shared_ptr<const Chunk> QueuedChunk;
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_queue_cv;
+    std::condition_variable m_flushed_cv;
+
+    // Saved since the current batch was taken
+    ChunkMap<QueuedChunk> m_pending;
+    // The batch being written, still visible to loads until it's on disk
+    ChunkMap<QueuedChunk> m_writing;
+    // Failed writes so far of chunks whose last write failed
+    ChunkMap<int> m_write_attempts;
+    bool m_flush_requested = false;
+    bool m_stopping = false;
+
+    Stats m_stats;
+
+    void io_loop();
+    void write_batch(const ChunkMap<QueuedChunk>& batch);
+};
+
+#endif
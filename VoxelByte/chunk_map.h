@@ -0,0 +1,206 @@
+#ifndef CHUNK_MAP_H
+#define CHUNK_MAP_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+typedef unsigned long long int ChunkID;
+
+// Chunk indices (world position / CHUNK_SIZE) are packed 21 bits per axis, biased so negative indices
+//   stay in their own field: x in bits 42..62, y in 21..41, z in 0..20. Covers -2^20..2^20 - 1 chunks per axis.
+static const int CHUNK_ID_AXIS_BITS = 21;
+static const int CHUNK_ID_AXIS_BIAS = 1 << (CHUNK_ID_AXIS_BITS - 1);
+static const ChunkID CHUNK_ID_AXIS_MASK = (ChunkID(1) << CHUNK_ID_AXIS_BITS) - 1;
+
+inline ChunkID PackChunkID(const glm::ivec3& chunk_idx)
+{
+    return (static_cast<ChunkID>(chunk_idx.x + CHUNK_ID_AXIS_BIAS) & CHUNK_ID_AXIS_MASK) << (2 * CHUNK_ID_AXIS_BITS) |
+           (static_cast<ChunkID>(chunk_idx.y + CHUNK_ID_AXIS_BIAS) & CHUNK_ID_AXIS_MASK) << CHUNK_ID_AXIS_BITS |
+           (static_cast<ChunkID>(chunk_idx.z + CHUNK_ID_AXIS_BIAS) & CHUNK_ID_AXIS_MASK);
+}
+
+inline glm::ivec3 UnpackChunkID(ChunkID chunk_id)
+{
+    return glm::ivec3(static_cast<int>((chunk_id >> (2 * CHUNK_ID_AXIS_BITS)) & CHUNK_ID_AXIS_MASK) - CHUNK_ID_AXIS_BIAS,
+                      static_cast<int>((chunk_id >> CHUNK_ID_AXIS_BITS) & CHUNK_ID_AXIS_MASK) - CHUNK_ID_AXIS_BIAS,
+                      static_cast<int>(chunk_id & CHUNK_ID_AXIS_MASK) - CHUNK_ID_AXIS_BIAS);
+}
+
+// Moves a packed key by one chunk along an axis without unpacking it. Only valid while the index stays
+//   inside the packed range; stepping past +-2^20 wraps into the opposite edge of the field. Loaded chunks
+//   always lie within MultiChunkSystem::IsInWorld(), so stepping from one to its neighbours is safe.
+static const ChunkID CHUNK_ID_STEP_X = ChunkID(1) << (2 * CHUNK_ID_AXIS_BITS);
+static const ChunkID CHUNK_ID_STEP_Y = ChunkID(1) << CHUNK_ID_AXIS_BITS;
+static const ChunkID CHUNK_ID_STEP_Z = ChunkID(1);
+
+// Refers to a chunk slot in MultiChunkSystem. Slots are reused once a chunk is evicted, and the
+//   generation tells a stale handle apart from one to whatever has moved into the slot since.
+struct ChunkHandle
+{
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return index != INVALID_INDEX; }
+};
+
+// Flat, open-addressed hash table keyed by packed ChunkIDs. Entries sit in one array and collisions probe
+//   the following slots, so a lookup is a hash and a short linear scan with no per-entry allocation.
+//   Erase shifts the rest of the probe run back rather than leaving tombstones. Any insert or erase may
+//   move entries, so pointers into the table and iterators don't survive them.
+template <typename T>
+class ChunkMap
+{
+public:
+    typedef std::pair<ChunkID, T> Entry;
+
+    // PackChunkID never sets the top bit, so this can't collide with a real key
+    static constexpr ChunkID EMPTY_KEY = ~ChunkID(0);
+
+    template <typename EntryType>
+    class Iterator
+    {
+    public:
+        Iterator(EntryType* entry, EntryType* end) : m_entry(entry), m_end(end) { skip_empty(); }
+
+        EntryType& operator*() const { return *m_entry; }
+        EntryType* operator->() const { return m_entry; }
+        Iterator& operator++() { m_entry++; skip_empty(); return *this; }
+        bool operator==(const Iterator& other) const { return m_entry == other.m_entry; }
+        bool operator!=(const Iterator& other) const { return m_entry != other.m_entry; }
+
+    private:
+        EntryType* m_entry;
+        EntryType* m_end;
+
+        void skip_empty() { while (m_entry != m_end && m_entry->first == EMPTY_KEY) m_entry++; }
+    };
+    typedef Iterator<Entry> iterator;
+    typedef Iterator<const Entry> const_iterator;
+
+    T* Find(ChunkID key)
+    {
+        if (m_size == 0) return nullptr;
+        for (size_t slot = home_slot(key); ; slot = (slot + 1) & m_mask)
+        {
+            if (m_entries[slot].first == key) return &m_entries[slot].second;
+            if (m_entries[slot].first == EMPTY_KEY) return nullptr;
+        }
+    }
+
+    const T* Find(ChunkID key) const
+    {
+        return const_cast<ChunkMap*>(this)->Find(key);
+    }
+
+    bool Contains(ChunkID key) const
+    {
+        return Find(key) != nullptr;
+    }
+
+    // Inserts a default constructed value if the key isn't present
+    T& operator[](ChunkID key)
+    {
+        if ((m_size + 1) * 4 > m_entries.size() * 3) rehash(m_entries.empty() ? 64 : m_entries.size() * 2);
+
+        size_t slot = home_slot(key);
+        while (m_entries[slot].first != EMPTY_KEY)
+        {
+            if (m_entries[slot].first == key) return m_entries[slot].second;
+            slot = (slot + 1) & m_mask;
+        }
+
+        m_entries[slot].first = key;
+        m_size++;
+        return m_entries[slot].second;
+    }
+
+    bool Erase(ChunkID key)
+    {
+        if (m_size == 0) return false;
+
+        size_t hole = home_slot(key);
+        while (m_entries[hole].first != key)
+        {
+            if (m_entries[hole].first == EMPTY_KEY) return false;
+            hole = (hole + 1) & m_mask;
+        }
+
+        // Pull back every later entry in the run that would still be reachable from its home slot
+        for (size_t next = (hole + 1) & m_mask; m_entries[next].first != EMPTY_KEY; next = (next + 1) & m_mask)
+        {
+            size_t probe_distance = (next - home_slot(m_entries[next].first)) & m_mask;
+            if (probe_distance < ((next - hole) & m_mask)) continue;
+
+            m_entries[hole] = std::move(m_entries[next]);
+            hole = next;
+        }
+
+        m_entries[hole] = Entry(EMPTY_KEY, T());
+        m_size--;
+        return true;
+    }
+
+    void Clear()
+    {
+        for (Entry& entry : m_entries) entry = Entry(EMPTY_KEY, T());
+        m_size = 0;
+    }
+
+    void Reserve(size_t count)
+    {
+        size_t capacity = m_entries.empty() ? 64 : m_entries.size();
+        while (count * 4 > capacity * 3) capacity *= 2;
+        if (capacity > m_entries.size()) rehash(capacity);
+    }
+
+    size_t Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+    size_t GetCapacity() const { return m_entries.size(); }
+
+    iterator begin() { return iterator(m_entries.data(), m_entries.data() + m_entries.size()); }
+    iterator end() { return iterator(m_entries.data() + m_entries.size(), m_entries.data() + m_entries.size()); }
+    const_iterator begin() const { return const_iterator(m_entries.data(), m_entries.data() + m_entries.size()); }
+    const_iterator end() const { return const_iterator(m_entries.data() + m_entries.size(), m_entries.data() + m_entries.size()); }
+
+private:
+    std::vector<Entry> m_entries;
+    size_t m_mask = 0;
+    size_t m_size = 0;
+
+    size_t home_slot(ChunkID key) const
+    {
+        // Neighbouring chunks differ in only a few bits, so mix them all down before masking (murmur3 finalizer)
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return static_cast<size_t>(key) & m_mask;
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<Entry> old_entries(capacity, Entry(EMPTY_KEY, T()));
+        old_entries.swap(m_entries);
+        m_mask = capacity - 1;
+
+        for (Entry& entry : old_entries)
+        {
+            if (entry.first == EMPTY_KEY) continue;
+
+            size_t slot = home_slot(entry.first);
+            while (m_entries[slot].first != EMPTY_KEY) slot = (slot + 1) & m_mask;
+            m_entries[slot] = std::move(entry);
+        }
+    }
+};
+
+// Set of packed ChunkIDs on the same flat table, the value is unused
+typedef ChunkMap<bool> ChunkSet;
+
+#endif
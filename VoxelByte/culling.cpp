@@ -0,0 +1,271 @@
+#include "culling.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VB_CULLING_SSE
+#include <emmintrin.h>
+#endif
+
+// ----------<[ FRUSTUM CLASS IMPLEMENTATION ]>----------
+
+Frustum::Frustum()
+{
+    Update(glm::mat4(1.0f));
+}
+
+Frustum::Frustum(const glm::mat4& view_projection)
+{
+    Update(view_projection);
+}
+
+void Frustum::Update(const glm::mat4& view_projection)
+{
+    // Gribb/Hartmann: each plane is the last row of the matrix plus or minus one of the others.
+    //   glm is column major, so row i is (m[0][i], m[1][i], m[2][i], m[3][i]).
+    auto row = [&view_projection](int i)
+    {
+        return glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+    };
+
+    glm::vec4 planes[PLANE_COUNT];
+    planes[PLANE_LEFT]   = row(3) + row(0);
+    planes[PLANE_RIGHT]  = row(3) - row(0);
+    planes[PLANE_BOTTOM] = row(3) + row(1);
+    planes[PLANE_TOP]    = row(3) - row(1);
+    planes[PLANE_NEAR]   = row(3) + row(2);
+    planes[PLANE_FAR]    = row(3) - row(2);
+
+    for (int i = 0; i < 8; i++)
+    {
+        glm::vec4 plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        if (i < PLANE_COUNT)
+        {
+            plane = planes[i];
+            float length = glm::length(glm::vec3(plane));
+            if (length > 0.0f) plane /= length;
+        }
+
+        m_plane_x[i] = plane.x;
+        m_plane_y[i] = plane.y;
+        m_plane_z[i] = plane.z;
+        m_plane_w[i] = plane.w;
+    }
+}
+
+bool Frustum::IsBoxVisible(const AABB& box) const
+{
+    // A box is outside if its most positive corner along a plane's normal is still behind that plane.
+    //   n.x * (n.x > 0 ? max.x : min.x) is the same as max(n.x * min.x, n.x * max.x), which avoids the select.
+#ifdef VB_CULLING_SSE
+    const __m128 min_x = _mm_set1_ps(box.min.x), max_x = _mm_set1_ps(box.max.x);
+    const __m128 min_y = _mm_set1_ps(box.min.y), max_y = _mm_set1_ps(box.max.y);
+    const __m128 min_z = _mm_set1_ps(box.min.z), max_z = _mm_set1_ps(box.max.z);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (int i = 0; i < 8; i += 4)
+    {
+        __m128 nx = _mm_load_ps(&m_plane_x[i]);
+        __m128 ny = _mm_load_ps(&m_plane_y[i]);
+        __m128 nz = _mm_load_ps(&m_plane_z[i]);
+        __m128 nw = _mm_load_ps(&m_plane_w[i]);
+
+        __m128 distance = _mm_add_ps(
+            _mm_add_ps(_mm_max_ps(_mm_mul_ps(nx, min_x), _mm_mul_ps(nx, max_x)),
+                       _mm_max_ps(_mm_mul_ps(ny, min_y), _mm_mul_ps(ny, max_y))),
+            _mm_add_ps(_mm_max_ps(_mm_mul_ps(nz, min_z), _mm_mul_ps(nz, max_z)), nw));
+
+        if (_mm_movemask_ps(_mm_cmplt_ps(distance, zero)) != 0) return false;
+    }
+
+    return true;
+#else
+    return IsBoxVisibleScalar(box);
+#endif
+}
+
+bool Frustum::IsBoxVisibleScalar(const AABB& box) const
+{
+    for (int i = 0; i < PLANE_COUNT; i++)
+    {
+        // Summed in the same order as the SSE2 lanes, so both round the same way
+        float distance = (std::fmax(m_plane_x[i] * box.min.x, m_plane_x[i] * box.max.x) +
+                          std::fmax(m_plane_y[i] * box.min.y, m_plane_y[i] * box.max.y)) +
+                         (std::fmax(m_plane_z[i] * box.min.z, m_plane_z[i] * box.max.z) + m_plane_w[i]);
+        if (distance < 0.0f) return false;
+    }
+
+    return true;
+}
+
+glm::vec4 Frustum::GetPlane(Plane plane) const
+{
+    return glm::vec4(m_plane_x[plane], m_plane_y[plane], m_plane_z[plane], m_plane_w[plane]);
+}
+
+// ----------<[ OCCLUSION CLASS IMPLEMENTATION ]>----------
+
+static int face_pair_bit(int face_a, int face_b)
+{
+    // Pairs (a, b) with a < b numbered 0..14
+    static const int pair_bits[6][6] =
+    {
+        { -1,  0,  1,  2,  3,  4 },
+        {  0, -1,  5,  6,  7,  8 },
+        {  1,  5, -1,  9, 10, 11 },
+        {  2,  6,  9, -1, 12, 13 },
+        {  3,  7, 10, 12, -1, 14 },
+        {  4,  8, 11, 13, 14, -1 },
+    };
+    return pair_bits[face_a][face_b];
+}
+
+bool FacesConnected(FaceConnectivity connectivity, int face_a, int face_b)
+{
+    if (face_a == face_b) return true;
+    return (connectivity >> face_pair_bit(face_a, face_b)) & 1;
+}
+
+FaceConnectivity ComputeFaceConnectivity(const uint8_t* voxels, int size, const bool solid[256])
+{
+    // The fill runs over 2^3 blocks that count as open if any voxel in them is. That can only join
+    //   regions, never split them, so the result stays conservative while the fill is 8x smaller.
+    const int cells = (size + 1) / 2;
+
+    thread_local std::vector<uint8_t> open;
+    thread_local std::vector<uint8_t> visited;
+    thread_local std::vector<int> stack;
+    open.assign(static_cast<size_t>(cells) * cells * cells, 0);
+    visited.assign(open.size(), 0);
+
+    for (int x = 0; x < size; x++)
+    {
+        for (int y = 0; y < size; y++)
+        {
+            const uint8_t* row = &voxels[(x * size + y) * size];
+            uint8_t* open_row = &open[((x >> 1) * cells + (y >> 1)) * cells];
+            for (int z = 0; z < size; z++)
+                open_row[z >> 1] |= !solid[row[z]];
+        }
+    }
+
+    const int stride[3] = { cells * cells, cells, 1 };
+    FaceConnectivity connectivity = 0;
+
+    auto faces_touched = [cells](int x, int y, int z)
+    {
+        int faces = 0;
+        if (x == cells - 1) faces |= 1 << 0;
+        if (x == 0)         faces |= 1 << 1;
+        if (y == cells - 1) faces |= 1 << 2;
+        if (y == 0)         faces |= 1 << 3;
+        if (z == cells - 1) faces |= 1 << 4;
+        if (z == 0)         faces |= 1 << 5;
+        return faces;
+    };
+
+    // Only regions touching the boundary matter, so fills start from boundary cells only
+    for (int x = 0; x < cells; x++)
+    for (int y = 0; y < cells; y++)
+    for (int z = 0; z < cells; z++)
+    {
+        if (faces_touched(x, y, z) == 0) continue;
+
+        int start = x * stride[0] + y * stride[1] + z;
+        if (!open[start] || visited[start]) continue;
+
+        int region_faces = 0;
+        visited[start] = 1;
+        stack.clear();
+        stack.push_back(start);
+
+        while (!stack.empty())
+        {
+            int index = stack.back();
+            stack.pop_back();
+
+            int p[3] = { index / stride[0], (index / stride[1]) % cells, index % cells };
+            region_faces |= faces_touched(p[0], p[1], p[2]);
+
+            for (int d = 0; d < 3; d++)
+            {
+                for (int step = -1; step <= 1; step += 2)
+                {
+                    int c = p[d] + step;
+                    if (c < 0 || c >= cells) continue;
+
+                    int next = index + step * stride[d];
+                    if (!open[next] || visited[next]) continue;
+
+                    visited[next] = 1;
+                    stack.push_back(next);
+                }
+            }
+        }
+
+        for (int a = 0; a < 6; a++)
+            for (int b = a + 1; b < 6; b++)
+                if ((region_faces >> a & 1) && (region_faces >> b & 1)) connectivity |= 1 << face_pair_bit(a, b);
+
+        if (connectivity == FACES_ALL_CONNECTED) return connectivity;
+    }
+
+    return connectivity;
+}
+
+void OcclusionCuller::Run(const glm::ivec3& start_idx, int entry_face, const Frustum& frustum, const ChunkLookup& lookup)
+{
+    static const glm::ivec3 face_offsets[6] =
+    {
+        glm::ivec3(1, 0, 0), glm::ivec3(-1, 0, 0),
+        glm::ivec3(0, 1, 0), glm::ivec3(0, -1, 0),
+        glm::ivec3(0, 0, 1), glm::ivec3(0, 0, -1)
+    };
+
+    m_visible.Clear();
+    m_queue.clear();
+
+    Step start;
+    if (!lookup(start_idx, start.node)) return;
+    start.chunk_idx = start_idx;
+    start.entry_face = entry_face;
+    // Entering from outside counts as having travelled away from that face already
+    start.directions = entry_face >= 0 ? static_cast<uint8_t>(1 << (entry_face ^ 1)) : 0;
+
+    m_visible[start.node.id] = true;
+    m_queue.push_back(start);
+
+    for (size_t i = 0; i < m_queue.size(); i++)
+    {
+        Step current = m_queue[i];
+
+        for (int face = 0; face < 6; face++)
+        {
+            // Never head back towards the camera
+            if (current.directions & (1 << (face ^ 1))) continue;
+            if (current.entry_face >= 0 && !FacesConnected(current.node.connectivity, current.entry_face, face)) continue;
+
+            Step next;
+            next.chunk_idx = current.chunk_idx + face_offsets[face];
+            if (!lookup(next.chunk_idx, next.node)) continue;
+            if (m_visible.Contains(next.node.id)) continue;
+            if (!frustum.IsBoxVisible(next.node.bounds)) continue;
+
+            next.entry_face = face ^ 1;
+            next.directions = current.directions | static_cast<uint8_t>(1 << face);
+
+            m_visible[next.node.id] = true;
+            m_queue.push_back(next);
+        }
+    }
+}
+
+bool OcclusionCuller::IsVisible(uint64_t id) const
+{
+    return m_visible.Contains(id);
+}
+
+size_t OcclusionCuller::GetVisibleCount() const
+{
+    return m_visible.Size();
+}
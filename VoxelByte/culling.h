@@ -0,0 +1,98 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include "chunk_map.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Axis-aligned box in world space
+struct AABB
+{
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+};
+
+// The six clip planes of a projection * view matrix. Doesn't touch GL, so it can be driven by any camera.
+class Frustum
+{
+public:
+    Frustum();
+    explicit Frustum(const glm::mat4& view_projection);
+
+    void Update(const glm::mat4& view_projection);
+
+    // Conservative: boxes straddling a plane count as visible
+    bool IsBoxVisible(const AABB& box) const;
+    // The same test one plane at a time, used where SSE2 isn't available and as the reference it's tested against
+    bool IsBoxVisibleScalar(const AABB& box) const;
+
+    enum Plane
+    {
+        PLANE_LEFT = 0,
+        PLANE_RIGHT,
+        PLANE_BOTTOM,
+        PLANE_TOP,
+        PLANE_NEAR,
+        PLANE_FAR,
+        PLANE_COUNT
+    };
+
+    // Normalized plane as (normal, distance), pointing into the frustum
+    glm::vec4 GetPlane(Plane plane) const;
+
+private:
+    // Plane components split into x/y/z/w lanes for the SIMD test. Padded to 8 with planes every box passes.
+    alignas(16) float m_plane_x[8];
+    alignas(16) float m_plane_y[8];
+    alignas(16) float m_plane_z[8];
+    alignas(16) float m_plane_w[8];
+};
+
+// One bit for each pair of the six chunk faces (+X, -X, +Y, -Y, +Z, -Z) that are joined by open voxels
+//   inside the chunk, i.e. whether something looking in through one face could see out of the other.
+typedef uint16_t FaceConnectivity;
+static const FaceConnectivity FACES_ALL_CONNECTED = 0x7FFF;
+
+// Flood fills the open (non-solid) voxels of a size^3 grid indexed [x][y][z]
+FaceConnectivity ComputeFaceConnectivity(const uint8_t* voxels, int size, const bool solid[256]);
+bool FacesConnected(FaceConnectivity connectivity, int face_a, int face_b);
+
+// Cave culling: a breadth-first walk over chunks starting at the camera, only passing from one chunk into
+//   the next through faces that are connected inside the chunk, never turning back towards the camera and
+//   staying inside the frustum. Chunks it never reaches are hidden behind solid ground.
+class OcclusionCuller
+{
+public:
+    struct Node
+    {
+        uint64_t id;
+        FaceConnectivity connectivity;
+        AABB bounds;
+    };
+    // Fills in the node for the chunk at a chunk index, returns false if nothing is loaded there
+    typedef std::function<bool(const glm::ivec3& chunk_idx, Node& node)> ChunkLookup;
+
+    // entry_face is the face the walk enters the start chunk through, or -1 if the camera is inside it
+    void Run(const glm::ivec3& start_idx, int entry_face, const Frustum& frustum, const ChunkLookup& lookup);
+
+    bool IsVisible(uint64_t id) const;
+    size_t GetVisibleCount() const;
+
+private:
+    struct Step
+    {
+        glm::ivec3 chunk_idx;
+        Node node;
+        int entry_face;
+        // Faces the walk has already left through, it may never leave through their opposites
+        uint8_t directions;
+    };
+
+    ChunkSet m_visible;
+    std::vector<Step> m_queue;
+};
+
+#endif
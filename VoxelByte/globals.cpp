@@ -5,12 +5,19 @@ void VB::init()
     m_logger = std::make_shared<Logger>();
     m_camera = std::make_shared<Camera>(glm::vec3(800.0f, 100.0f, 950.0f));
     m_chunksystem = std::make_shared<MultiChunkSystem>();
+    m_world = std::make_shared<World>();
     m_noisegenerator = std::make_shared<NoiseGenerator>();
+    m_terraingenerator = std::make_shared<TerrainGenerator>();
+    m_regionstore = std::make_shared<RegionStore>();
+    m_chunkio = std::make_shared<ChunkIOService>();
+    m_chunkcodec = std::make_shared<ChunkCodec>();
     m_voxel = std::make_shared<VoxelRenderer>();
     m_clock = std::make_shared<Clock>();
     m_player = std::make_shared<Player>();
     m_gui = std::make_shared<GUI>();
     m_input = std::make_shared<Input>();
+    m_threadpool = std::make_shared<ThreadPool>();
+    m_profiler = std::make_shared<Profiler>();
     VB::inst().GetLogger()->Print("Singleton class constructed");
 }
 
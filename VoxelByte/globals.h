@@ -4,10 +4,18 @@
 #include "logger.h"
 #include "camera.h"
 #include "voxel.h"
+#include "world.h"
+#include "noise.h"
+#include "terrain.h"
+#include "region.h"
+#include "chunk_io.h"
+#include "chunk_codec.h"
 #include "clock.h"
 #include "player.h"
 #include "gui.h"
 #include "input.h"
+#include "threadpool.h"
+#include "profiler.h"
 
 #include <memory>
 
@@ -21,12 +29,19 @@ public:
     std::shared_ptr<Logger>             GetLogger()             { return m_logger; }
     std::shared_ptr<Camera>             GetCamera()             { return m_camera; }
     std::shared_ptr<MultiChunkSystem>   GetMultiChunkSystem()   { return m_chunksystem; }
+    std::shared_ptr<World>              GetWorld()              { return m_world; }
     std::shared_ptr<NoiseGenerator>     GetNoiseGenerator()     { return m_noisegenerator; }
+    std::shared_ptr<TerrainGenerator>   GetTerrainGenerator()   { return m_terraingenerator; }
+    std::shared_ptr<RegionStore>        GetRegionStore()        { return m_regionstore; }
+    std::shared_ptr<ChunkIOService>     GetChunkIO()            { return m_chunkio; }
+    std::shared_ptr<ChunkCodec>         GetChunkCodec()         { return m_chunkcodec; }
     std::shared_ptr<VoxelRenderer>      GetVoxel()              { return m_voxel; }
     std::shared_ptr<Clock>              GetClock()              { return m_clock; }
     std::shared_ptr<Player>             GetPlayer()             { return m_player; }
     std::shared_ptr<GUI>                GetGUI()                { return m_gui; }
     std::shared_ptr<Input>              GetInput()              { return m_input; }
+    std::shared_ptr<ThreadPool>         GetThreadPool()         { return m_threadpool; }
+    std::shared_ptr<Profiler>           GetProfiler()           { return m_profiler; }
 
 private:
     static VB m_voxelbyte_inst;
@@ -34,12 +49,19 @@ private:
     std::shared_ptr<Logger>             m_logger;
     std::shared_ptr<Camera>             m_camera;
     std::shared_ptr<MultiChunkSystem>   m_chunksystem;
+    std::shared_ptr<World>              m_world;
     std::shared_ptr<NoiseGenerator>     m_noisegenerator;
+    std::shared_ptr<TerrainGenerator>   m_terraingenerator;
+    std::shared_ptr<RegionStore>        m_regionstore;
+    std::shared_ptr<ChunkIOService>     m_chunkio;
+    std::shared_ptr<ChunkCodec>         m_chunkcodec;
     std::shared_ptr<VoxelRenderer>      m_voxel;
     std::shared_ptr<Clock>              m_clock;
     std::shared_ptr<Player>             m_player;
     std::shared_ptr<GUI>                m_gui;
     std::shared_ptr<Input>              m_input;
+    std::shared_ptr<ThreadPool>         m_threadpool;
+    std::shared_ptr<Profiler>           m_profiler;
 };
 
 #endif
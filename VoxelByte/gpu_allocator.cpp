@@ -0,0 +1,184 @@
+#include "gpu_allocator.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+
+GpuAllocator::GpuAllocator(size_t capacity, size_t alignment)
+    : m_capacity(0), m_alignment(std::max<size_t>(alignment, 1))
+{
+    Grow(capacity);
+}
+
+size_t GpuAllocator::Allocate(size_t size, uint64_t owner)
+{
+    if (size == 0) return INVALID_OFFSET;
+    size = align(size);
+
+    for (auto it = m_free_ranges.begin(); it != m_free_ranges.end(); it++)
+    {
+        if (it->second < size) continue;
+
+        size_t offset = it->first;
+        size_t remaining = it->second - size;
+        m_free_ranges.erase(it);
+        if (remaining > 0) m_free_ranges[offset + size] = remaining;
+
+        m_allocations[offset] = { size, owner };
+        m_used += size;
+        return offset;
+    }
+
+    return INVALID_OFFSET;
+}
+
+void GpuAllocator::Free(size_t offset)
+{
+    auto allocation = m_allocations.find(offset);
+    if (allocation == m_allocations.end()) throw std::out_of_range("GpuAllocator::Free offset is not allocated");
+
+    insert_free_range(offset, allocation->second.size);
+    m_used -= allocation->second.size;
+    m_allocations.erase(allocation);
+}
+
+bool GpuAllocator::Resize(size_t offset, size_t new_size)
+{
+    auto allocation = m_allocations.find(offset);
+    if (allocation == m_allocations.end()) throw std::out_of_range("GpuAllocator::Resize offset is not allocated");
+    if (new_size == 0) return false;
+
+    size_t old_size = allocation->second.size;
+    new_size = align(new_size);
+    if (new_size == old_size) return true;
+
+    if (new_size < old_size)
+    {
+        insert_free_range(offset + new_size, old_size - new_size);
+    }
+    else
+    {
+        // Only possible if the range right after the allocation is free and big enough
+        auto next = m_free_ranges.find(offset + old_size);
+        if (next == m_free_ranges.end() || next->second < new_size - old_size) return false;
+
+        size_t remaining = next->second - (new_size - old_size);
+        m_free_ranges.erase(next);
+        if (remaining > 0) m_free_ranges[offset + new_size] = remaining;
+    }
+
+    m_used = m_used - old_size + new_size;
+    allocation->second.size = new_size;
+    return true;
+}
+
+void GpuAllocator::Grow(size_t new_capacity)
+{
+    new_capacity = align(new_capacity);
+    if (new_capacity <= m_capacity) return;
+
+    size_t old_capacity = m_capacity;
+    m_capacity = new_capacity;
+    insert_free_range(old_capacity, new_capacity - old_capacity);
+}
+
+bool GpuAllocator::NextCompactionMove(Move& move) const
+{
+    if (m_free_ranges.empty()) return false;
+
+    int candidates = 0;
+    for (auto allocation = m_allocations.rbegin(); allocation != m_allocations.rend() && candidates < COMPACTION_CANDIDATES; allocation++, candidates++)
+    {
+        for (const auto& range : m_free_ranges)
+        {
+            // Free ranges are sorted, so nothing further along is below the allocation
+            if (range.first > allocation->first) break;
+            if (range.second < allocation->second.size) continue;
+
+            move = { allocation->first, range.first, allocation->second.size, allocation->second.owner };
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void GpuAllocator::ApplyMove(const Move& move)
+{
+    auto allocation = m_allocations.find(move.from);
+    if (allocation == m_allocations.end()) throw std::out_of_range("GpuAllocator::ApplyMove source is not allocated");
+
+    auto range = m_free_ranges.find(move.to);
+    if (range == m_free_ranges.end() || range->second < move.size) throw std::out_of_range("GpuAllocator::ApplyMove destination is not free");
+
+    size_t remaining = range->second - move.size;
+    m_free_ranges.erase(range);
+    if (remaining > 0) m_free_ranges[move.to + move.size] = remaining;
+
+    Allocation moved = allocation->second;
+    m_allocations.erase(allocation);
+    m_allocations[move.to] = moved;
+    insert_free_range(move.from, moved.size);
+}
+
+GpuAllocator::Stats GpuAllocator::GetStats() const
+{
+    Stats stats;
+    stats.capacity = m_capacity;
+    stats.used = m_used;
+    stats.free = m_capacity - m_used;
+    stats.free_ranges = m_free_ranges.size();
+    stats.allocations = m_allocations.size();
+
+    for (const auto& range : m_free_ranges)
+        stats.largest_free = std::max(stats.largest_free, range.second);
+
+    if (stats.free > 0) stats.fragmentation = 1.0f - static_cast<float>(stats.largest_free) / static_cast<float>(stats.free);
+    return stats;
+}
+
+size_t GpuAllocator::GetAllocationSize(size_t offset) const
+{
+    auto allocation = m_allocations.find(offset);
+    if (allocation == m_allocations.end()) return 0;
+    return allocation->second.size;
+}
+
+size_t GpuAllocator::GetCapacity() const
+{
+    return m_capacity;
+}
+
+size_t GpuAllocator::GetAlignment() const
+{
+    return m_alignment;
+}
+
+size_t GpuAllocator::align(size_t size) const
+{
+    return (size + m_alignment - 1) / m_alignment * m_alignment;
+}
+
+void GpuAllocator::insert_free_range(size_t offset, size_t size)
+{
+    if (size == 0) return;
+
+    auto it = m_free_ranges.emplace(offset, size).first;
+
+    auto next = std::next(it);
+    if (next != m_free_ranges.end() && it->first + it->second == next->first)
+    {
+        it->second += next->second;
+        m_free_ranges.erase(next);
+    }
+
+    if (it != m_free_ranges.begin())
+    {
+        auto prev = std::prev(it);
+        if (prev->first + prev->second == it->first)
+        {
+            prev->second += it->second;
+            m_free_ranges.erase(it);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef GPU_ALLOCATOR_H
+#define GPU_ALLOCATOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <map>
+
+// Hands out ranges of a large GPU buffer. Only does the bookkeeping: offsets and sizes are in whatever
+// unit the caller picks (vertices, indices, bytes) and the caller owns the buffer itself, so this can be
+// used and tested without a GL context.
+class GpuAllocator
+{
+public:
+    static const size_t INVALID_OFFSET = SIZE_MAX;
+
+    // Every allocation is rounded up to a multiple of alignment, so offsets are aligned too
+    GpuAllocator(size_t capacity = 0, size_t alignment = 1);
+
+    // First fit. Returns INVALID_OFFSET when no free range is large enough; Grow() and try again.
+    size_t Allocate(size_t size, uint64_t owner);
+    void Free(size_t offset);
+    // Shrinks or extends the allocation at offset without moving it. Fails if the range after it is taken.
+    bool Resize(size_t offset, size_t new_size);
+    // Appends free space at the end. The caller is responsible for copying the buffer contents.
+    void Grow(size_t new_capacity);
+
+    // One step of compaction: the highest allocation that fits into a lower free range is moved there
+    struct Move
+    {
+        size_t from;
+        size_t to;
+        size_t size;
+        uint64_t owner;
+    };
+    bool NextCompactionMove(Move& move) const;
+    // Call once the data has actually been copied from move.from to move.to
+    void ApplyMove(const Move& move);
+
+    struct Stats
+    {
+        size_t capacity = 0;
+        size_t used = 0;
+        size_t free = 0;
+        size_t largest_free = 0;
+        size_t free_ranges = 0;
+        size_t allocations = 0;
+        // 0 when all free space is one range, approaching 1 as it splinters into small holes
+        float fragmentation = 0.0f;
+    };
+    Stats GetStats() const;
+
+    size_t GetAllocationSize(size_t offset) const;
+    size_t GetCapacity() const;
+    size_t GetAlignment() const;
+
+private:
+    size_t align(size_t size) const;
+    void insert_free_range(size_t offset, size_t size);
+
+    struct Allocation
+    {
+        size_t size;
+        uint64_t owner;
+    };
+
+    size_t m_capacity;
+    size_t m_alignment;
+    size_t m_used = 0;
+    // offset -> size of every free range. Adjacent ranges are always merged.
+    std::map<size_t, size_t> m_free_ranges;
+    std::map<size_t, Allocation> m_allocations;
+
+    // Allocations looked at per NextCompactionMove() call, keeps a single step cheap
+    static const int COMPACTION_CANDIDATES = 32;
+};
+
+#endif
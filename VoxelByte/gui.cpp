@@ -53,6 +53,8 @@ void GUI::UpdateImGui(GLFWwindow* window)
     ImGui::Text("Camera Position:");
     ImGui::Text("X: %.2f, Y: %.2f, Z: %.2f", VB::inst().GetCamera()->Position.x, VB::inst().GetCamera()->Position.y, VB::inst().GetCamera()->Position.z);
     ImGui::Text("Yaw: %.1f, Pitch: %.1f", VB::inst().GetCamera()->Yaw, VB::inst().GetCamera()->Pitch);
+    uint8_t camera_voxel = VB::inst().GetWorld()->GetVoxel(glm::ivec3(glm::floor(VB::inst().GetCamera()->Position)));
+    ImGui::Text("Voxel: %s", VoxelRenderer::GetVoxelData(camera_voxel).name);
 
     ImGui::Separator();
     if (ImGui::CollapsingHeader("Window")) {
@@ -101,6 +103,180 @@ void GUI::UpdateImGui(GLFWwindow* window)
         ImGui::Spacing();
     }
 
+    ImGui::Separator();
+    if (ImGui::CollapsingHeader("Chunks")) {
+        ImGui::Text("Loaded: %zu", VB::inst().GetMultiChunkSystem()->get_chunk_map().Size());
+        ImGui::Text("Pending Uploads: %zu", VB::inst().GetVoxel()->GetPendingUploadCount());
+        ImGui::Text("Memory (RSS): %.1f MiB", VB::inst().GetProfiler()->GetCurrentRSS() / (1024.0 * 1024.0));
+        size_t chunk_count = VB::inst().GetMultiChunkSystem()->get_chunk_map().Size();
+        size_t voxel_memory = VB::inst().GetMultiChunkSystem()->GetVoxelMemoryUsage();
+        ImGui::Text("Voxel Memory: %.2f MiB", voxel_memory / (1024.0 * 1024.0));
+        ImGui::Text("Per Chunk: %.1f KiB", chunk_count > 0 ? voxel_memory / 1024.0 / chunk_count : 0.0);
+        VoxelRenderer::MeshStats mesh_stats = VB::inst().GetVoxel()->GetMeshStats();
+        ImGui::Text("Quads: %zu (%.0f / mesh), %zu sections", mesh_stats.quads, mesh_stats.meshes > 0 ? static_cast<double>(mesh_stats.quads) / mesh_stats.meshes : 0.0, mesh_stats.sections);
+        ImGui::Text("Mesh Memory: %.2f / %.2f MiB", mesh_stats.bytes / (1024.0 * 1024.0), mesh_stats.arena_bytes / (1024.0 * 1024.0));
+        VoxelRenderer::ArenaStats arena_stats = VB::inst().GetVoxel()->GetArenaStats();
+        ImGui::Text("Vertex Arena: %.0f%% used, %zu holes, %.0f%% fragmented",
+            arena_stats.vertices.capacity > 0 ? 100.0 * arena_stats.vertices.used / arena_stats.vertices.capacity : 0.0,
+            arena_stats.vertices.free_ranges, 100.0 * arena_stats.vertices.fragmentation);
+        ImGui::Text("Index Arena: %.0f%% used, %zu holes, %.0f%% fragmented",
+            arena_stats.indices.capacity > 0 ? 100.0 * arena_stats.indices.used / arena_stats.indices.capacity : 0.0,
+            arena_stats.indices.free_ranges, 100.0 * arena_stats.indices.fragmentation);
+        ImGui::Text("Reused In Place: %zu, Compaction Moves: %zu", arena_stats.reused_in_place, arena_stats.compaction_moves);
+        ImGui::Text("Page Padding: %.2f MiB (%.0f%% of used vertices)", arena_stats.page_padding_vertices * sizeof(uint32_t) / (1024.0 * 1024.0),
+            arena_stats.vertices.used > 0 ? 100.0 * arena_stats.page_padding_vertices / arena_stats.vertices.used : 0.0);
+        const VoxelRenderer::RenderStats& render_stats = VB::inst().GetVoxel()->GetRenderStats();
+        ImGui::Text("Draw Calls: %zu (%zu sections, %zu chunks + %zu sections culled)", render_stats.draw_calls, render_stats.drawn,
+            render_stats.culled, render_stats.sections_culled);
+        ImGui::Checkbox("Occlusion Culling", &occlusionCulling);
+        ImGui::Text("Occluded: %zu (%.2f ms)", render_stats.occluded, render_stats.occlusion_ms);
+        std::array<size_t, MultiChunkSystem::MAX_LOD + 1> lod_counts = VB::inst().GetMultiChunkSystem()->GetLODCounts();
+        ImGui::Text("Chunks per LOD: %zu / %zu / %zu / %zu", lod_counts[0], lod_counts[1], lod_counts[2], lod_counts[3]);
+        RegionStore::Stats disk_stats = VB::inst().GetRegionStore()->GetStats();
+        ImGui::Text("Disk: %zu loaded (%.3f ms each), %zu saved, %.1f MiB written, %zu regions open", disk_stats.chunks_loaded,
+            disk_stats.chunks_loaded > 0 ? disk_stats.load_seconds * 1000.0 / disk_stats.chunks_loaded : 0.0,
+            disk_stats.chunks_saved, disk_stats.bytes_written / (1024.0 * 1024.0), disk_stats.open_regions);
+        ChunkIOService::Stats io_stats = VB::inst().GetChunkIO()->GetStats();
+        ImGui::Text("Save Queue: %zu pending, %zu coalesced, %zu batches (%zu region writes), %zu failed, %zu dropped", io_stats.pending,
+            io_stats.coalesced, io_stats.batches, io_stats.region_writes, io_stats.failed, io_stats.dropped);
+        size_t column_hits = VB::inst().GetTerrainGenerator()->GetColumnCacheHits();
+        size_t column_misses = VB::inst().GetTerrainGenerator()->GetColumnCacheMisses();
+        ImGui::Text("Terrain Column Cache: %zu hits, %zu misses", column_hits, column_misses);
+        ImGui::Separator();
+        ImGui::Text("Chunk Radius:");
+        ImGui::SliderInt("      ", &chunkRadius, 1, 32);
+        ImGui::Text("Vertical Radius:");
+        ImGui::SliderInt("        ", &verticalRadius, 0, 8);
+        ImGui::Text("Full Detail Radius:");
+        ImGui::SliderInt("       ", &lodRadius, 1, 32);
+        ImGui::Text("Mesh Uploads / Frame:");
+        ImGui::SliderInt("    ", &meshUploadsPerFrame, 1, 64);
+        ImGui::Text("Upload Budget / Frame (KiB):");
+        ImGui::SliderInt("     ", &meshUploadKiBPerFrame, 256, 65536);
+        ImGui::Spacing();
+    }
+    VB::inst().GetVoxel()->SetUploadBudget(static_cast<size_t>(meshUploadKiBPerFrame) * 1024, meshUploadsPerFrame);
+    VB::inst().GetMultiChunkSystem()->SetChunkGenRadius(chunkRadius);
+    VB::inst().GetMultiChunkSystem()->SetVerticalRadius(verticalRadius);
+    VB::inst().GetMultiChunkSystem()->SetLODRadius(lodRadius);
+    VB::inst().GetVoxel()->SetOcclusionCulling(occlusionCulling);
+
+    ImGui::Separator();
+    if (ImGui::CollapsingHeader("Editing")) {
+        ImGui::Text("Hold RMB to aim, LMB breaks, MMB places");
+        ImGui::Text("Place Block: %s", VoxelRenderer::GetVoxelData(static_cast<uint8_t>(placeVoxelId)).name);
+        ImGui::SliderInt("         ", &placeVoxelId, 1, 5);
+        ImGui::Text("Reach:");
+        ImGui::SliderFloat("          ", &editReach, 1.0f, 128.0f);
+        const VoxelRenderer::EditStats& edit_stats = VB::inst().GetVoxel()->GetLastEditStats();
+        ImGui::Text("Last Edit: %zu chunks (%zu sections, %.1f KiB) in %.2f ms", edit_stats.chunks, edit_stats.sections,
+            edit_stats.bytes / 1024.0, edit_stats.milliseconds);
+        ImGui::Spacing();
+    }
+    VB::inst().GetInput()->SetPlaceVoxel(static_cast<uint8_t>(placeVoxelId));
+    VB::inst().GetInput()->SetEditReach(editReach);
+
+    ImGui::Separator();
+    if (ImGui::CollapsingHeader("Benchmark")) {
+        if (VB::inst().GetProfiler()->IsBenchmarkRunning()) {
+            if (ImGui::Button("Stop Camera Path")) VB::inst().GetProfiler()->StopCameraPathBenchmark();
+        }
+        else {
+            if (ImGui::Button("Run Camera Path")) VB::inst().GetProfiler()->StartCameraPathBenchmark();
+        }
+
+        const Profiler::BenchmarkResult& result = VB::inst().GetProfiler()->GetLastBenchmark();
+        if (result.valid) {
+            ImGui::Text("Duration: %.1f s", result.duration);
+            ImGui::Text("Chunks Loaded: %zu (%.1f / s)", result.chunks_loaded, result.chunks_per_sec);
+            ImGui::Text("Avg Frame: %.2f ms", result.avg_frame_ms);
+            ImGui::Text("Worst Frame: %.2f ms", result.worst_frame_ms);
+            ImGui::Text("Peak RSS: %.1f MiB", result.peak_rss / (1024.0 * 1024.0));
+        }
+
+        ImGui::Separator();
+        if (ImGui::Button("Run Noise Benchmark")) VB::inst().GetNoiseGenerator()->RunBenchmark();
+
+        const NoiseGenerator::BenchmarkResult& noise_result = VB::inst().GetNoiseGenerator()->GetLastBenchmark();
+        if (noise_result.valid) {
+            ImGui::Text("Scalar: %.1f M samples / s", noise_result.scalar_samples_per_sec / 1e6);
+            ImGui::Text("Batch (%s): %.1f M samples / s", noise_result.simd, noise_result.batch_samples_per_sec / 1e6);
+            ImGui::Text("Speedup: %.1fx, Max Error: %.2g", noise_result.scalar_samples_per_sec > 0.0 ? noise_result.batch_samples_per_sec / noise_result.scalar_samples_per_sec : 0.0, noise_result.max_error);
+        }
+
+        ImGui::Separator();
+        if (ImGui::Button("Run Terrain Benchmark")) VB::inst().GetTerrainGenerator()->RunBenchmark();
+
+        const TerrainGenerator::BenchmarkResult& terrain_result = VB::inst().GetTerrainGenerator()->GetLastBenchmark();
+        if (terrain_result.valid) {
+            ImGui::Text("Chunks: %zu in %.1f ms (%.1f / s)", terrain_result.chunks, terrain_result.seconds * 1000.0, terrain_result.seconds > 0.0 ? terrain_result.chunks / terrain_result.seconds : 0.0);
+            for (int stage = 0; stage < TerrainGenerator::STAGE_COUNT; stage++) {
+                const TerrainGenerator::StageStats& stats = terrain_result.stages[stage];
+                ImGui::Text("%s: %zu runs, %.3f ms each", TerrainGenerator::GetStageName(static_cast<TerrainGenerator::Stage>(stage)),
+                    stats.runs, stats.runs > 0 ? stats.seconds * 1000.0 / stats.runs : 0.0);
+            }
+        }
+
+        ImGui::Separator();
+        if (ImGui::Button("Run Region Benchmark")) VB::inst().GetRegionStore()->RunBenchmark();
+
+        const RegionStore::BenchmarkResult& region_result = VB::inst().GetRegionStore()->GetLastBenchmark();
+        if (region_result.valid) {
+            ImGui::Text("Chunks: %zu, %.1f KiB on disk (%.0f B each)", region_result.chunks, region_result.payload_bytes / 1024.0,
+                region_result.chunks > 0 ? static_cast<double>(region_result.payload_bytes) / region_result.chunks : 0.0);
+            ImGui::Text("Generate: %.1f ms, Save: %.1f ms, Load: %.1f ms", region_result.generate_seconds * 1000.0,
+                region_result.save_seconds * 1000.0, region_result.load_seconds * 1000.0);
+            ImGui::Text("Load vs Generate: %.1fx, Round Trip: %s", region_result.load_seconds > 0.0 ? region_result.generate_seconds / region_result.load_seconds : 0.0,
+                region_result.mismatched_chunks == 0 ? "OK" : "MISMATCH");
+        }
+
+        ImGui::Separator();
+        if (ImGui::Button("Run Codec Benchmark")) VB::inst().GetChunkCodec()->RunBenchmark();
+
+        const ChunkCodec::BenchmarkResult& codec_result = VB::inst().GetChunkCodec()->GetLastBenchmark();
+        if (codec_result.valid) {
+            double raw_bytes = static_cast<double>(codec_result.raw_bytes) * codec_result.repeats;
+            ImGui::Text("Chunks: %zu x %d, Run Detection: %s", codec_result.chunks, codec_result.repeats, ChunkCodec::GetSimdName());
+            ImGui::Text("Sections: %.1f KiB (%.0fx)", codec_result.section_bytes / 1024.0,
+                codec_result.section_bytes > 0 ? static_cast<double>(codec_result.raw_bytes) / codec_result.section_bytes : 0.0);
+            ImGui::Text("Runs: %.1f KiB (%.0fx), encode %.2f GB/s, decode %.2f GB/s", codec_result.run_bytes / 1024.0,
+                codec_result.run_bytes > 0 ? static_cast<double>(codec_result.raw_bytes) / codec_result.run_bytes : 0.0,
+                codec_result.run_encode_seconds > 0.0 ? raw_bytes / codec_result.run_encode_seconds * 1e-9 : 0.0,
+                codec_result.run_decode_seconds > 0.0 ? raw_bytes / codec_result.run_decode_seconds * 1e-9 : 0.0);
+            ImGui::Text("Runs + LZ: %.1f KiB (%.0fx), encode %.2f GB/s, decode %.2f GB/s", codec_result.lz_bytes / 1024.0,
+                codec_result.lz_bytes > 0 ? static_cast<double>(codec_result.raw_bytes) / codec_result.lz_bytes : 0.0,
+                codec_result.lz_encode_seconds > 0.0 ? raw_bytes / codec_result.lz_encode_seconds * 1e-9 : 0.0,
+                codec_result.lz_decode_seconds > 0.0 ? raw_bytes / codec_result.lz_decode_seconds * 1e-9 : 0.0);
+            ImGui::Text("Round Trip: %s", codec_result.mismatched_chunks == 0 ? "OK" : "MISMATCH");
+        }
+
+        ImGui::Separator();
+        ImGui::Text("World Seed: %d", VB::inst().GetNoiseGenerator()->GetSeed());
+        if (ImGui::Button("Run Determinism Check")) VB::inst().GetTerrainGenerator()->RunDeterminismCheck();
+
+        const TerrainGenerator::DeterminismResult& determinism = VB::inst().GetTerrainGenerator()->GetLastDeterminismCheck();
+        if (determinism.valid) {
+            ImGui::Text("Seed %d, %zu chunks, %u workers", determinism.seed, determinism.chunks, determinism.threads);
+            ImGui::Text("Single Thread: %016llx", static_cast<unsigned long long>(determinism.single_thread_hash));
+            ImGui::Text("Multi Thread:  %016llx", static_cast<unsigned long long>(determinism.multi_thread_hash));
+            ImGui::Text(determinism.mismatched_chunks == 0 ? "Deterministic" : "MISMATCH: %zu chunks differ", determinism.mismatched_chunks);
+        }
+
+        ImGui::Separator();
+        if (ImGui::Button("Run Mesher Benchmark")) VB::inst().GetVoxel()->RunMesherBenchmark();
+
+        const VoxelRenderer::MesherBenchmarkResult& mesher_result = VB::inst().GetVoxel()->GetLastMesherBenchmark();
+        if (mesher_result.valid) {
+            double meshes = static_cast<double>(mesher_result.chunks) * mesher_result.repeats;
+            ImGui::Text("Chunks: %zu x %d, Quads: %zu", mesher_result.chunks, mesher_result.repeats, mesher_result.quads);
+            ImGui::Text("Bitmask: %.3f ms/chunk, Greedy: %.3f ms/chunk", mesher_result.seconds * 1000.0 / meshes,
+                mesher_result.reference_seconds * 1000.0 / meshes);
+            ImGui::Text("Speedup: %.1fx, Quads: %s", mesher_result.seconds > 0.0 ? mesher_result.reference_seconds / mesher_result.seconds : 0.0,
+                mesher_result.mismatched_chunks == 0 ? "OK" : "MISMATCH");
+        }
+        ImGui::Spacing();
+    }
+
     ImGui::End();
 }
 
@@ -22,6 +22,14 @@ public:
     bool wireFrameMode = false;
     float viewDistance = 1000.0f;
     float cameraSpeed = 100.0f;
+    int chunkRadius = 4;
+    int verticalRadius = 2;
+    int lodRadius = 4;
+    bool occlusionCulling = true;
+    int meshUploadsPerFrame = 8;
+    int meshUploadKiBPerFrame = 4096;
+    int placeVoxelId = 3;
+    float editReach = 16.0f;
 
     void SetupCrosshairMesh();
 
@@ -34,4 +34,42 @@ void Input::ProcessInput(GLFWwindow* window) {
         VB::inst().GetCamera()->ProcessKeyboard(UP, deltaTime);
     if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS)
         VB::inst().GetCamera()->ProcessKeyboard(DOWN, deltaTime);
+
+    // Voxel editing, only while aiming with the crosshair so clicks on the debug menu don't reach the world
+    bool aiming = glfwGetInputMode(window, GLFW_CURSOR) == GLFW_CURSOR_DISABLED;
+    bool break_down = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+    bool place_down = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_MIDDLE) == GLFW_PRESS;
+    if (aiming && break_down && !m_break_was_down) edit_voxel(false);
+    if (aiming && place_down && !m_place_was_down) edit_voxel(true);
+    m_break_was_down = break_down;
+    m_place_was_down = place_down;
+}
+
+void Input::SetPlaceVoxel(uint8_t id)
+{
+    m_place_voxel = id;
+}
+
+void Input::SetEditReach(float reach)
+{
+    m_edit_reach = reach;
+}
+
+void Input::edit_voxel(bool place)
+{
+    std::shared_ptr<Camera> camera = VB::inst().GetCamera();
+    World::RaycastHit hit;
+    if (!VB::inst().GetWorld()->Raycast(camera->Position, camera->Front, m_edit_reach, hit)) return;
+
+    if (!place)
+    {
+        if (VoxelRenderer::GetVoxelData(hit.id).destructible) VB::inst().GetWorld()->EditVoxel(hit.position, 0);
+        return;
+    }
+
+    // A ray starting inside a solid voxel has no face to place against
+    if (hit.normal == glm::ivec3(0)) return;
+    glm::ivec3 target = hit.position + hit.normal;
+    if (glm::ivec3(glm::floor(camera->Position)) == target) return;
+    VB::inst().GetWorld()->EditVoxel(target, m_place_voxel);
 }
\ No newline at end of file
@@ -4,12 +4,28 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <cstdint>
+
 class Input
 {
 public:
 	Input();
 
 	void ProcessInput(GLFWwindow* window);
+
+	// While looking around (right mouse held), left click breaks the voxel under the crosshair and middle
+	//   click places m_place_voxel against the face it points at, up to m_edit_reach voxels away
+	void SetPlaceVoxel(uint8_t id);
+	void SetEditReach(float reach);
+
+private:
+	uint8_t m_place_voxel = 3;
+	float m_edit_reach = 16.0f;
+	// Button state last frame, an edit happens once per press
+	bool m_break_was_down = false;
+	bool m_place_was_down = false;
+
+	void edit_voxel(bool place);
 };
 
 #endif
@@ -2,7 +2,7 @@
 
 Logger::Logger()
 {
-    VB::inst().GetLogger()->Print("Logger obj constructed");
+    Print("Logger obj constructed");
 }
 
 std::string Logger::GetCurrentTime()
@@ -36,10 +36,12 @@ std::string Logger::GetCurrentTime()
 
 void Logger::Print(std::string message)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
 	std::cout << GetCurrentTime() << " <VoxelByte> " << message << '\n';
 }
 
 void Logger::PrintErr(std::string message)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     std::cout << GetCurrentTime() << " <VoxelByte> ERROR: " << message << '\n';
 }
\ No newline at end of file
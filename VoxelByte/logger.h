@@ -5,6 +5,7 @@
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
 
 class Logger
 {
@@ -15,6 +16,10 @@ public:
 
 	void Print(std::string message);
 	void PrintErr(std::string message);
+
+private:
+	// Worker threads log too, so lines are written one at a time
+	std::mutex m_mutex;
 };
 
 #endif
\ No newline at end of file
@@ -13,15 +13,36 @@
 
 #include "shader.h"
 #include "window.h"
+#include "tests.h"
 
 #include <iostream>
 #include <unordered_map>
 
-int main() {
+int main(int argc, char** argv) {
 
     // Initialize Global Class
     VB::inst().init();
 
+    // Headless checks: VoxelByte --test [filter], exits non-zero if any failed
+    if (argc > 1 && std::string(argv[1]) == "--test")
+    {
+        int failed = TestRunner::Run(argc > 2 ? argv[2] : "");
+        VB::inst().GetThreadPool()->Shutdown();
+        VB::inst().GetChunkIO()->Shutdown();
+        VB::inst().GetRegionStore()->CloseAll();
+        return failed == 0 ? 0 : 1;
+    }
+
+    // Headless benchmarks: VoxelByte --bench <name>
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+    {
+        bool found = TestRunner::RunBenchmark(argc > 2 ? argv[2] : "");
+        VB::inst().GetThreadPool()->Shutdown();
+        VB::inst().GetChunkIO()->Shutdown();
+        VB::inst().GetRegionStore()->CloseAll();
+        return found ? 0 : 1;
+    }
+
     // Create window
     Window window(1920, 1080, "VoxelByte");
 
@@ -34,22 +55,25 @@ int main() {
     // Setup crosshair
     VB::inst().GetGUI()->SetupCrosshairMesh();
 
-    VB::inst().GetMultiChunkSystem()->update();
-
     VB::inst().GetVoxel()->SetShader(VoxelShader);
-    for (const auto& id_chunk : VB::inst().GetMultiChunkSystem()->get_chunk_map())
-    {
-        VoxelRenderer::VoxelMesh curr_mesh = VB::inst().GetVoxel()->GenerateChunkMesh(*(id_chunk.second));
-        VB::inst().GetVoxel()->BufferVoxelMesh(id_chunk.first, curr_mesh);
-    }
+
     // Enable OpenGL functionality
     glEnable(GL_DEPTH_TEST);
 
     // Render loop
     while (!window.ShouldClose()) {
         VB::inst().GetClock()->Update();
+        VB::inst().GetProfiler()->Update();
         VB::inst().GetInput()->ProcessInput(window.GetGLFWwindow());
 
+        // Queue missing chunks, remesh this frame's edits straight away, mesh the chunks the workers have
+        //   finished and upload what fits this frame
+        VB::inst().GetMultiChunkSystem()->update();
+        VB::inst().GetVoxel()->RemeshEditedChunks(VB::inst().GetMultiChunkSystem()->TakeEditedChunks());
+        for (const ChunkID& chunk_id : VB::inst().GetMultiChunkSystem()->TakeChunksToMesh())
+            VB::inst().GetVoxel()->QueueChunkMesh(chunk_id);
+        VB::inst().GetVoxel()->UploadPendingMeshes();
+
         glClearColor(0.7f, 0.7f, 0.7f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -75,7 +99,7 @@ int main() {
         glUniformMatrix4fv(glGetUniformLocation(VoxelShader->ID, "model"),
             1, GL_FALSE, glm::value_ptr(model));
 
-        VB::inst().GetVoxel()->RenderAllMeshes();
+        VB::inst().GetVoxel()->RenderAllMeshes(projection * view);
 
         crosshairShader.use();
         glBindVertexArray(VB::inst().GetGUI()->crosshairVAO);
@@ -91,7 +115,12 @@ int main() {
         window.PollEvents();
     }
 
-    // Cleanup
+    // Cleanup, the workers are stopped first so no chunk changes while it's being saved, and the I/O thread
+    //   has written everything out before the region files are closed
+    VB::inst().GetThreadPool()->Shutdown();
+    VB::inst().GetMultiChunkSystem()->SaveAllChunks();
+    VB::inst().GetChunkIO()->Shutdown();
+    VB::inst().GetRegionStore()->CloseAll();
     VB::inst().GetVoxel()->FreeRenderMeshes();
 
     ImGui_ImplOpenGL3_Shutdown();
@@ -0,0 +1,411 @@
+#include "globals.h"
+
+#include <array>
+#include <cmath>
+#include <chrono>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VB_NOISE_SSE
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define VB_NOISE_AVX2_TARGET
+#else
+#define VB_NOISE_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+// Constants from FastNoiseLite's OpenSimplex2 2D, evaluated the same way (in float) so the batch path
+//   rounds exactly like the scalar one
+static const float SQRT3 = 1.7320508075688772935274463415059f;
+static const float SIMPLEX_F2 = 0.5f * (SQRT3 - 1);
+static const float SIMPLEX_G2 = (3 - SQRT3) / 6;
+static const float SIMPLEX_C_T = static_cast<float>(2 * (1 - 2 * SIMPLEX_G2) * (1 / SIMPLEX_G2 - 2));
+static const float SIMPLEX_C_A = static_cast<float>(-2 * (1 - 2 * SIMPLEX_G2) * (1 - 2 * SIMPLEX_G2));
+static const float SIMPLEX_SCALE = 99.83685446303647f;
+static const int PRIME_X = 501125321;
+static const int PRIME_Y = 1136930381;
+static const int HASH_MULTIPLIER = 0x27d4eb2d;
+
+// FastNoiseLite's 2D gradient table (private to it): 24 unit vectors at 7.5 + 15k degrees repeated five
+//   times, then 8 at 22.5 + 45k degrees to fill the 128 (x, y) pairs
+static std::array<float, 256> make_gradients_2d()
+{
+    std::array<float, 256> gradients;
+    for (int i = 0; i < 128; i++)
+    {
+        double degrees = i < 120 ? 7.5 + 15.0 * (i % 24) : 22.5 + 45.0 * (i - 120);
+        double angle = degrees * 3.14159265358979323846 / 180.0;
+        gradients[i * 2] = static_cast<float>(std::sin(angle));
+        gradients[i * 2 + 1] = static_cast<float>(std::cos(angle));
+    }
+    return gradients;
+}
+static const std::array<float, 256> GRADIENTS_2D = make_gradients_2d();
+
+#ifdef VB_NOISE_SSE
+static bool cpu_has_avx2()
+{
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+
+    // AVX registers also need OS support (OSXSAVE, and XCR0 saving the SSE and AVX state)
+    __cpuid(regs, 1);
+    if ((regs[2] & (1 << 27)) == 0 || (regs[2] & (1 << 28)) == 0) return false;
+    if ((_xgetbv(0) & 6) != 6) return false;
+
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static const bool HAS_AVX2 = cpu_has_avx2();
+static bool USE_AVX2 = HAS_AVX2;
+
+// SSE2 has no 32-bit multiply, blend or gather, those are emulated below
+
+static inline __m128i mullo_epi32_sse2(__m128i a, __m128i b)
+{
+    // SSE2 only multiplies the even lanes, so do the odd ones separately and interleave the low halves
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline __m128 select_sse2(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128i fast_floor_sse2(__m128 f)
+{
+    // FastNoiseLite's FastFloor: truncate, minus one for anything negative
+    return _mm_add_epi32(_mm_cvttps_epi32(f), _mm_castps_si128(_mm_cmplt_ps(f, _mm_setzero_ps())));
+}
+
+static inline __m128 grad_coord_sse2(__m128i seed, __m128i x_primed, __m128i y_primed, __m128 xd, __m128 yd)
+{
+    __m128i hash = mullo_epi32_sse2(_mm_xor_si128(_mm_xor_si128(seed, x_primed), y_primed), _mm_set1_epi32(HASH_MULTIPLIER));
+    hash = _mm_xor_si128(hash, _mm_srai_epi32(hash, 15));
+    hash = _mm_and_si128(hash, _mm_set1_epi32(127 << 1));
+
+    alignas(16) int index[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(index), hash);
+    __m128 xg = _mm_setr_ps(GRADIENTS_2D[index[0]], GRADIENTS_2D[index[1]], GRADIENTS_2D[index[2]], GRADIENTS_2D[index[3]]);
+    __m128 yg = _mm_setr_ps(GRADIENTS_2D[index[0] | 1], GRADIENTS_2D[index[1] | 1], GRADIENTS_2D[index[2] | 1], GRADIENTS_2D[index[3] | 1]);
+
+    return _mm_add_ps(_mm_mul_ps(xd, xg), _mm_mul_ps(yd, yg));
+}
+
+// Samples (world_x, world_y + n) for n in [0, count), returns how many it did (a multiple of 4)
+static int simplex2_row_sse2(int seed, float frequency, int world_x, int world_y, int count, float* out)
+{
+    const __m128i v_seed = _mm_set1_epi32(seed);
+    const __m128i prime_x = _mm_set1_epi32(PRIME_X);
+    const __m128i prime_y = _mm_set1_epi32(PRIME_Y);
+    const __m128 v_frequency = _mm_set1_ps(frequency);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 g2 = _mm_set1_ps(SIMPLEX_G2);
+    const __m128 g2_minus_1 = _mm_set1_ps(SIMPLEX_G2 - 1);
+    const __m128 two_g2_minus_1 = _mm_set1_ps(2 * SIMPLEX_G2 - 1);
+    const __m128 xs = _mm_set1_ps(static_cast<float>(world_x) * frequency);
+
+    int n = 0;
+    for (; n + 4 <= count; n += 4)
+    {
+        // Frequency and skew (FastNoiseLite's TransformNoiseCoordinate)
+        __m128i y_coord = _mm_add_epi32(_mm_set1_epi32(world_y + n), _mm_setr_epi32(0, 1, 2, 3));
+        __m128 ys = _mm_mul_ps(_mm_cvtepi32_ps(y_coord), v_frequency);
+        __m128 skew = _mm_mul_ps(_mm_add_ps(xs, ys), _mm_set1_ps(SIMPLEX_F2));
+        __m128 x = _mm_add_ps(xs, skew);
+        __m128 y = _mm_add_ps(ys, skew);
+
+        __m128i i = fast_floor_sse2(x);
+        __m128i j = fast_floor_sse2(y);
+        __m128 xi = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+        __m128 yi = _mm_sub_ps(y, _mm_cvtepi32_ps(j));
+
+        __m128 t = _mm_mul_ps(_mm_add_ps(xi, yi), g2);
+        __m128 x0 = _mm_sub_ps(xi, t);
+        __m128 y0 = _mm_sub_ps(yi, t);
+
+        i = mullo_epi32_sse2(i, prime_x);
+        j = mullo_epi32_sse2(j, prime_y);
+
+        __m128 a = _mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0));
+        __m128 n0 = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(a, a), _mm_mul_ps(a, a)), grad_coord_sse2(v_seed, i, j, x0, y0));
+        n0 = _mm_and_ps(n0, _mm_cmpgt_ps(a, zero));
+
+        __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SIMPLEX_C_T), t), _mm_add_ps(_mm_set1_ps(SIMPLEX_C_A), a));
+        __m128 x2 = _mm_add_ps(x0, two_g2_minus_1);
+        __m128 y2 = _mm_add_ps(y0, two_g2_minus_1);
+        __m128 n2 = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(c, c), _mm_mul_ps(c, c)),
+                               grad_coord_sse2(v_seed, _mm_add_epi32(i, prime_x), _mm_add_epi32(j, prime_y), x2, y2));
+        n2 = _mm_and_ps(n2, _mm_cmpgt_ps(c, zero));
+
+        // Middle corner is (0, 1) above the diagonal, (1, 0) below it
+        __m128 upper = _mm_cmpgt_ps(y0, x0);
+        __m128i upper_int = _mm_castps_si128(upper);
+        __m128 x1 = select_sse2(upper, _mm_add_ps(x0, g2), _mm_add_ps(x0, g2_minus_1));
+        __m128 y1 = select_sse2(upper, _mm_add_ps(y0, g2_minus_1), _mm_add_ps(y0, g2));
+        __m128i i1 = _mm_add_epi32(i, _mm_andnot_si128(upper_int, prime_x));
+        __m128i j1 = _mm_add_epi32(j, _mm_and_si128(upper_int, prime_y));
+        __m128 b = _mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1));
+        __m128 n1 = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(b, b), _mm_mul_ps(b, b)), grad_coord_sse2(v_seed, i1, j1, x1, y1));
+        n1 = _mm_and_ps(n1, _mm_cmpgt_ps(b, zero));
+
+        _mm_storeu_ps(out + n, _mm_mul_ps(_mm_add_ps(_mm_add_ps(n0, n1), n2), _mm_set1_ps(SIMPLEX_SCALE)));
+    }
+
+    return n;
+}
+
+// AVX2 versions, only called once cpu_has_avx2() has said so
+
+VB_NOISE_AVX2_TARGET static inline __m256i fast_floor_avx2(__m256 f)
+{
+    return _mm256_add_epi32(_mm256_cvttps_epi32(f), _mm256_castps_si256(_mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_LT_OQ)));
+}
+
+VB_NOISE_AVX2_TARGET static inline __m256 grad_coord_avx2(__m256i seed, __m256i x_primed, __m256i y_primed, __m256 xd, __m256 yd)
+{
+    __m256i hash = _mm256_mullo_epi32(_mm256_xor_si256(_mm256_xor_si256(seed, x_primed), y_primed), _mm256_set1_epi32(HASH_MULTIPLIER));
+    hash = _mm256_xor_si256(hash, _mm256_srai_epi32(hash, 15));
+    hash = _mm256_and_si256(hash, _mm256_set1_epi32(127 << 1));
+
+    __m256 xg = _mm256_i32gather_ps(GRADIENTS_2D.data(), hash, 4);
+    __m256 yg = _mm256_i32gather_ps(GRADIENTS_2D.data() + 1, hash, 4);
+
+    return _mm256_add_ps(_mm256_mul_ps(xd, xg), _mm256_mul_ps(yd, yg));
+}
+
+// Same as simplex2_row_sse2, 8 samples at a time
+VB_NOISE_AVX2_TARGET static int simplex2_row_avx2(int seed, float frequency, int world_x, int world_y, int count, float* out)
+{
+    const __m256i v_seed = _mm256_set1_epi32(seed);
+    const __m256i prime_x = _mm256_set1_epi32(PRIME_X);
+    const __m256i prime_y = _mm256_set1_epi32(PRIME_Y);
+    const __m256 v_frequency = _mm256_set1_ps(frequency);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 g2 = _mm256_set1_ps(SIMPLEX_G2);
+    const __m256 g2_minus_1 = _mm256_set1_ps(SIMPLEX_G2 - 1);
+    const __m256 two_g2_minus_1 = _mm256_set1_ps(2 * SIMPLEX_G2 - 1);
+    const __m256 xs = _mm256_set1_ps(static_cast<float>(world_x) * frequency);
+
+    int n = 0;
+    for (; n + 8 <= count; n += 8)
+    {
+        __m256i y_coord = _mm256_add_epi32(_mm256_set1_epi32(world_y + n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256 ys = _mm256_mul_ps(_mm256_cvtepi32_ps(y_coord), v_frequency);
+        __m256 skew = _mm256_mul_ps(_mm256_add_ps(xs, ys), _mm256_set1_ps(SIMPLEX_F2));
+        __m256 x = _mm256_add_ps(xs, skew);
+        __m256 y = _mm256_add_ps(ys, skew);
+
+        __m256i i = fast_floor_avx2(x);
+        __m256i j = fast_floor_avx2(y);
+        __m256 xi = _mm256_sub_ps(x, _mm256_cvtepi32_ps(i));
+        __m256 yi = _mm256_sub_ps(y, _mm256_cvtepi32_ps(j));
+
+        __m256 t = _mm256_mul_ps(_mm256_add_ps(xi, yi), g2);
+        __m256 x0 = _mm256_sub_ps(xi, t);
+        __m256 y0 = _mm256_sub_ps(yi, t);
+
+        i = _mm256_mullo_epi32(i, prime_x);
+        j = _mm256_mullo_epi32(j, prime_y);
+
+        __m256 a = _mm256_sub_ps(_mm256_sub_ps(half, _mm256_mul_ps(x0, x0)), _mm256_mul_ps(y0, y0));
+        __m256 n0 = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(a, a)), grad_coord_avx2(v_seed, i, j, x0, y0));
+        n0 = _mm256_and_ps(n0, _mm256_cmp_ps(a, zero, _CMP_GT_OQ));
+
+        __m256 c = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(SIMPLEX_C_T), t), _mm256_add_ps(_mm256_set1_ps(SIMPLEX_C_A), a));
+        __m256 x2 = _mm256_add_ps(x0, two_g2_minus_1);
+        __m256 y2 = _mm256_add_ps(y0, two_g2_minus_1);
+        __m256 n2 = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(c, c), _mm256_mul_ps(c, c)),
+                                  grad_coord_avx2(v_seed, _mm256_add_epi32(i, prime_x), _mm256_add_epi32(j, prime_y), x2, y2));
+        n2 = _mm256_and_ps(n2, _mm256_cmp_ps(c, zero, _CMP_GT_OQ));
+
+        __m256 upper = _mm256_cmp_ps(y0, x0, _CMP_GT_OQ);
+        __m256i upper_int = _mm256_castps_si256(upper);
+        __m256 x1 = _mm256_blendv_ps(_mm256_add_ps(x0, g2_minus_1), _mm256_add_ps(x0, g2), upper);
+        __m256 y1 = _mm256_blendv_ps(_mm256_add_ps(y0, g2), _mm256_add_ps(y0, g2_minus_1), upper);
+        __m256i i1 = _mm256_add_epi32(i, _mm256_andnot_si256(upper_int, prime_x));
+        __m256i j1 = _mm256_add_epi32(j, _mm256_and_si256(upper_int, prime_y));
+        __m256 b = _mm256_sub_ps(_mm256_sub_ps(half, _mm256_mul_ps(x1, x1)), _mm256_mul_ps(y1, y1));
+        __m256 n1 = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(b, b), _mm256_mul_ps(b, b)), grad_coord_avx2(v_seed, i1, j1, x1, y1));
+        n1 = _mm256_and_ps(n1, _mm256_cmp_ps(b, zero, _CMP_GT_OQ));
+
+        _mm256_storeu_ps(out + n, _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(n0, n1), n2), _mm256_set1_ps(SIMPLEX_SCALE)));
+    }
+
+    return n;
+}
+#endif
+
+// ----------<[ NOISEGENERATOR CLASS IMPLEMENTATION ]>----------
+NoiseGenerator::NoiseGenerator()
+{
+    m_noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    m_noise.SetSeed(m_seed);
+    m_noise.SetFrequency(m_freq);
+
+    VB::inst().GetLogger()->Print(std::string("NoiseGenerator obj constructed, batch noise uses ") + GetSimdName());
+}
+
+const FastNoiseLite& NoiseGenerator::GetNoise() const
+{
+    return m_noise;
+}
+
+void NoiseGenerator::FillNoise2D(glm::ivec2 origin, glm::ivec2 size, float* out) const
+{
+    fill_noise_2d(m_noise, m_seed, m_freq, origin, size, out);
+}
+
+void NoiseGenerator::FillNoise2D(int seed, float frequency, glm::ivec2 origin, glm::ivec2 size, float* out) const
+{
+    // Only the row tails need this, and setting one up is a handful of stores
+    FastNoiseLite noise(seed);
+    noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    noise.SetFrequency(frequency);
+
+    fill_noise_2d(noise, seed, frequency, origin, size, out);
+}
+
+void NoiseGenerator::SetSeed(int seed)
+{
+    m_seed = seed;
+    m_noise.SetSeed(seed);
+}
+
+void NoiseGenerator::SetFrequency(float frequency)
+{
+    m_freq = frequency;
+    m_noise.SetFrequency(frequency);
+}
+
+int NoiseGenerator::GetSeed() const
+{
+    return m_seed;
+}
+
+float NoiseGenerator::GetFrequency() const
+{
+    return m_freq;
+}
+
+void NoiseGenerator::fill_noise_2d(const FastNoiseLite& noise, int seed, float frequency, glm::ivec2 origin, glm::ivec2 size, float* out) const
+{
+    for (int x = 0; x < size.x; x++)
+    {
+        float* row = out + static_cast<size_t>(x) * size.y;
+        int done = 0;
+
+#ifdef VB_NOISE_SSE
+        if (USE_AVX2) done = simplex2_row_avx2(seed, frequency, origin.x + x, origin.y, size.y, row);
+        else done = simplex2_row_sse2(seed, frequency, origin.x + x, origin.y, size.y, row);
+#endif
+
+        // Whatever doesn't fill a whole vector goes through FastNoiseLite itself
+        for (int y = done; y < size.y; y++)
+            row[y] = noise.GetNoise(static_cast<float>(origin.x + x), static_cast<float>(origin.y + y));
+    }
+}
+
+const char* NoiseGenerator::GetSimdName()
+{
+#ifdef VB_NOISE_SSE
+    return USE_AVX2 ? "AVX2" : "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+bool NoiseGenerator::SetUseAVX2(bool use_avx2)
+{
+#ifdef VB_NOISE_SSE
+    if (use_avx2 && !HAS_AVX2) return false;
+    USE_AVX2 = use_avx2;
+    return true;
+#else
+    return false;
+#endif
+}
+
+const NoiseGenerator::BenchmarkResult& NoiseGenerator::RunBenchmark(int heightmaps)
+{
+    const int size = Chunk::CHUNK_SIZE;
+    std::vector<float> scalar(static_cast<size_t>(size) * size);
+    std::vector<float> batch(scalar.size());
+
+    BenchmarkResult result;
+    result.valid = true;
+    result.simd = GetSimdName();
+    result.samples = static_cast<size_t>(heightmaps) * scalar.size();
+
+    double scalar_seconds = 0.0;
+    double batch_seconds = 0.0;
+    for (int h = 0; h < heightmaps; h++)
+    {
+        // Spread the heightmaps out so both paths see negative and large coordinates
+        glm::ivec2 origin((h % 16 - 8) * 4096, (h / 16 - 8) * 4096);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int x = 0; x < size; x++)
+            for (int y = 0; y < size; y++)
+                scalar[x * size + y] = m_noise.GetNoise(static_cast<float>(origin.x + x), static_cast<float>(origin.y + y));
+        auto middle = std::chrono::steady_clock::now();
+        FillNoise2D(origin, glm::ivec2(size), batch.data());
+        auto end = std::chrono::steady_clock::now();
+
+        scalar_seconds += std::chrono::duration<double>(middle - start).count();
+        batch_seconds += std::chrono::duration<double>(end - middle).count();
+
+        for (size_t i = 0; i < scalar.size(); i++)
+            result.max_error = std::max(result.max_error, std::fabs(scalar[i] - batch[i]));
+    }
+
+    if (scalar_seconds > 0.0) result.scalar_samples_per_sec = result.samples / scalar_seconds;
+    if (batch_seconds > 0.0) result.batch_samples_per_sec = result.samples / batch_seconds;
+
+    m_last_benchmark = result;
+    VB::inst().GetLogger()->Print("Noise benchmark: " + std::to_string(result.scalar_samples_per_sec / 1e6) + " M/s scalar, " +
+                                  std::to_string(result.batch_samples_per_sec / 1e6) + " M/s " + result.simd);
+    return m_last_benchmark;
+}
+
+const NoiseGenerator::BenchmarkResult& NoiseGenerator::GetLastBenchmark() const
+{
+    return m_last_benchmark;
+}
+
+// ----------<[ CHUNKRANDOM CLASS IMPLEMENTATION ]>----------
+ChunkRandom::ChunkRandom(int seed, const glm::ivec3& chunk_idx)
+{
+    // Packed chunk ids only use the low 63 bits, the seed is spread over all 64 by the golden ratio multiply
+    m_state = PackChunkID(chunk_idx) ^ (static_cast<uint64_t>(static_cast<uint32_t>(seed)) * 0x9e3779b97f4a7c15ULL);
+}
+
+uint64_t ChunkRandom::Next()
+{
+    uint64_t z = (m_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+uint32_t ChunkRandom::NextInt(uint32_t bound)
+{
+    // Multiply-shift instead of a modulo, any bias is at most bound / 2^32
+    return static_cast<uint32_t>(((Next() >> 32) * bound) >> 32);
+}
+
+float ChunkRandom::NextFloat()
+{
+    return static_cast<float>(Next() >> 40) * (1.0f / 16777216.0f);
+}
@@ -0,0 +1,74 @@
+#ifndef NOISE_H
+#define NOISE_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include "../include/FastNoiseLite/FastNoiseLite.h"
+
+class NoiseGenerator
+{
+public:
+    NoiseGenerator();
+
+    const FastNoiseLite& GetNoise() const;
+
+    // Fills out[x * size.y + y] with GetNoise().GetNoise(origin.x + x, origin.y + y), evaluating 8 (AVX2)
+    //   or 4 (SSE2) samples at a time. Follows FastNoiseLite's OpenSimplex2 step for step, so results only
+    //   differ from the scalar path by float contraction the compiler may apply to either.
+    void FillNoise2D(glm::ivec2 origin, glm::ivec2 size, float* out) const;
+    // Same, for OpenSimplex2 with another seed and frequency (terrain layers beyond the base one)
+    void FillNoise2D(int seed, float frequency, glm::ivec2 origin, glm::ivec2 size, float* out) const;
+
+    // Workers read these without locking, so only change them before any chunks are generated
+    void SetSeed(int seed);
+    void SetFrequency(float frequency);
+    int GetSeed() const;
+    float GetFrequency() const;
+    // Instruction set FillNoise2D uses, the best this CPU has unless SetUseAVX2 said otherwise
+    static const char* GetSimdName();
+    // Switches FillNoise2D between the AVX2 and SSE2 kernels, so both can be checked on one CPU. Returns
+    //   false, changing nothing, if the CPU (or build) lacks the one asked for. Same rule as SetSeed.
+    static bool SetUseAVX2(bool use_avx2);
+
+    struct BenchmarkResult
+    {
+        bool valid = false;
+        const char* simd = "";
+        size_t samples = 0;
+        double scalar_samples_per_sec = 0.0;
+        double batch_samples_per_sec = 0.0;
+        float max_error = 0.0f;
+    };
+    // Times a run of 64x64 heightmaps through the scalar FastNoiseLite path and through FillNoise2D
+    const BenchmarkResult& RunBenchmark(int heightmaps = 256);
+    const BenchmarkResult& GetLastBenchmark() const;
+
+private:
+    // Kept alongside m_noise, FastNoiseLite has no getters and the batch path needs them
+    int m_seed = 6;
+    float m_freq = 0.01f;
+    FastNoiseLite m_noise;
+
+    BenchmarkResult m_last_benchmark;
+
+    void fill_noise_2d(const FastNoiseLite& noise, int seed, float frequency, glm::ivec2 origin, glm::ivec2 size, float* out) const;
+};
+
+// splitmix64 stream seeded from the world seed and a chunk index, so a chunk draws the same numbers
+//   no matter how many workers there are or which order they run in
+class ChunkRandom
+{
+public:
+    ChunkRandom(int seed, const glm::ivec3& chunk_idx);
+
+    uint64_t Next();
+    // Uniform in [0, bound), bound > 0
+    uint32_t NextInt(uint32_t bound);
+    // Uniform in [0, 1)
+    float NextFloat();
+
+private:
+    uint64_t m_state;
+};
+
+#endif
@@ -0,0 +1,258 @@
+#include "palette.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+// Packs the palette indices of count ids at a fixed width, so the per-word loop can be unrolled
+template <int BITS>
+static void pack_indices(const uint8_t* in, const int16_t* palette_index, size_t count, uint64_t* words)
+{
+    const size_t per_word = 64 / BITS;
+    for (size_t i = 0; i < count; i += per_word)
+    {
+        uint64_t word = 0;
+        size_t entries = std::min(per_word, count - i);
+        for (size_t e = 0; e < entries; e++)
+            word |= static_cast<uint64_t>(palette_index[in[i + e]]) << (e * BITS);
+        words[i / per_word] = word;
+    }
+}
+
+PaletteStorage::PaletteStorage(size_t voxel_count, uint8_t fill_id)
+    : m_size(voxel_count)
+{
+    m_palette.push_back(fill_id);
+}
+
+uint8_t PaletteStorage::Get(size_t index) const
+{
+    if (index >= m_size) throw std::out_of_range("PaletteStorage::Get index out of range");
+    return GetUnchecked(index);
+}
+
+void PaletteStorage::Set(size_t index, uint8_t id)
+{
+    if (index >= m_size) throw std::out_of_range("PaletteStorage::Set index out of range");
+
+    int palette_index = find_palette_index(id);
+    if (palette_index < 0)
+    {
+        if (m_palette.size() >= (size_t(1) << m_bits))
+            repack(m_bits == 0 ? 1 : m_bits * 2, nullptr);
+
+        palette_index = static_cast<int>(m_palette.size());
+        m_palette.push_back(id);
+    }
+
+    if (m_bits == 0) return;
+
+    size_t bit = index * m_bits;
+    uint64_t& word = m_data[bit >> 6];
+    word = (word & ~(m_mask << (bit & 63))) | (static_cast<uint64_t>(palette_index) << (bit & 63));
+}
+
+void PaletteStorage::Fill(uint8_t id)
+{
+    m_bits = 0;
+    m_mask = 0;
+    m_palette.assign(1, id);
+    std::vector<uint64_t>().swap(m_data);
+}
+
+void PaletteStorage::Decode(uint8_t* out) const
+{
+    if (m_bits == 0)
+    {
+        std::fill(out, out + m_size, m_palette[0]);
+        return;
+    }
+
+    // Walk the packed words directly instead of recomputing the bit offset per entry
+    const int per_word = 64 / m_bits;
+    size_t i = 0;
+    for (uint64_t word : m_data)
+    {
+        for (int e = 0; e < per_word && i < m_size; e++, i++)
+        {
+            out[i] = m_palette[word & m_mask];
+            word >>= m_bits;
+        }
+    }
+}
+
+void PaletteStorage::Encode(const uint8_t* in)
+{
+    // Most sections are all air or all stone, comparing the ids against themselves shifted by one settles
+    //   that with a vectorized memcmp
+    if (m_size <= 1 || std::memcmp(in, in + 1, m_size - 1) == 0)
+    {
+        Fill(m_size > 0 ? in[0] : m_palette[0]);
+        return;
+    }
+
+    // Palette in first seen order, then every entry packed once at the final width
+    int16_t palette_index[256];
+    std::fill(palette_index, palette_index + 256, int16_t(-1));
+    std::vector<uint8_t> palette;
+    for (size_t i = 0; i < m_size; i++)
+    {
+        if (palette_index[in[i]] >= 0) continue;
+        palette_index[in[i]] = static_cast<int16_t>(palette.size());
+        palette.push_back(in[i]);
+    }
+
+    int bits = 1;
+    while ((size_t(1) << bits) < palette.size()) bits *= 2;
+
+    std::vector<uint64_t> words((m_size * bits + 63) / 64, 0);
+    switch (bits)
+    {
+    case 1: pack_indices<1>(in, palette_index, m_size, words.data()); break;
+    case 2: pack_indices<2>(in, palette_index, m_size, words.data()); break;
+    case 4: pack_indices<4>(in, palette_index, m_size, words.data()); break;
+    default: pack_indices<8>(in, palette_index, m_size, words.data()); break;
+    }
+
+    m_bits = bits;
+    m_mask = (uint64_t(1) << bits) - 1;
+    m_palette.swap(palette);
+    m_data.swap(words);
+}
+
+void PaletteStorage::Optimize()
+{
+    if (m_bits == 0) return;
+
+    bool used[256] = { false };
+    for (size_t i = 0; i < m_size; i++)
+    {
+        size_t bit = i * m_bits;
+        used[(m_data[bit >> 6] >> (bit & 63)) & m_mask] = true;
+    }
+
+    std::vector<uint8_t> new_palette;
+    uint8_t palette_remap[256] = { 0 };
+    for (size_t i = 0; i < m_palette.size(); i++)
+    {
+        if (!used[i]) continue;
+        palette_remap[i] = static_cast<uint8_t>(new_palette.size());
+        new_palette.push_back(m_palette[i]);
+    }
+
+    if (new_palette.size() == 1)
+    {
+        Fill(new_palette[0]);
+        return;
+    }
+    if (new_palette.size() == m_palette.size()) return;
+
+    int new_bits = 1;
+    while ((size_t(1) << new_bits) < new_palette.size()) new_bits *= 2;
+
+    repack(new_bits, palette_remap);
+    m_palette.swap(new_palette);
+}
+
+void PaletteStorage::Serialize(std::vector<uint8_t>& out) const
+{
+    // Bit width, palette size - 1, palette, then the words as they sit in memory (little endian)
+    out.push_back(static_cast<uint8_t>(m_bits));
+    out.push_back(static_cast<uint8_t>(m_palette.size() - 1));
+    out.insert(out.end(), m_palette.begin(), m_palette.end());
+
+    size_t offset = out.size();
+    out.resize(offset + m_data.size() * sizeof(uint64_t));
+    if (!m_data.empty()) std::memcpy(out.data() + offset, m_data.data(), m_data.size() * sizeof(uint64_t));
+}
+
+bool PaletteStorage::Deserialize(const uint8_t*& data, const uint8_t* end)
+{
+    if (end - data < 2) return false;
+
+    int bits = data[0];
+    size_t palette_size = static_cast<size_t>(data[1]) + 1;
+    if (bits != 0 && bits != 1 && bits != 2 && bits != 4 && bits != 8) return false;
+    if (palette_size > (size_t(1) << bits)) return false;
+
+    size_t word_count = (m_size * bits + 63) / 64;
+    if (static_cast<size_t>(end - data) < 2 + palette_size + word_count * sizeof(uint64_t)) return false;
+
+    std::vector<uint8_t> palette(data + 2, data + 2 + palette_size);
+    std::vector<uint64_t> words(word_count);
+    if (word_count > 0) std::memcpy(words.data(), data + 2 + palette_size, word_count * sizeof(uint64_t));
+
+    // Indices past the end of a partly filled palette would read out of bounds later
+    uint64_t mask = (uint64_t(1) << bits) - 1;
+    if (palette_size < (size_t(1) << bits))
+    {
+        for (size_t i = 0; i < m_size; i++)
+        {
+            size_t bit = i * bits;
+            if (((words[bit >> 6] >> (bit & 63)) & mask) >= palette_size) return false;
+        }
+    }
+
+    m_bits = bits;
+    m_mask = mask;
+    m_palette.swap(palette);
+    m_data.swap(words);
+    data += 2 + palette_size + word_count * sizeof(uint64_t);
+    return true;
+}
+
+size_t PaletteStorage::GetSize() const
+{
+    return m_size;
+}
+
+bool PaletteStorage::IsUniform() const
+{
+    return m_bits == 0;
+}
+
+int PaletteStorage::GetBitsPerVoxel() const
+{
+    return m_bits;
+}
+
+size_t PaletteStorage::GetPaletteSize() const
+{
+    return m_palette.size();
+}
+
+size_t PaletteStorage::GetMemoryUsage() const
+{
+    return sizeof(PaletteStorage) + m_palette.capacity() * sizeof(uint8_t) + m_data.capacity() * sizeof(uint64_t);
+}
+
+int PaletteStorage::find_palette_index(uint8_t id) const
+{
+    for (size_t i = 0; i < m_palette.size(); i++)
+        if (m_palette[i] == id) return static_cast<int>(i);
+    return -1;
+}
+
+void PaletteStorage::repack(int new_bits, const uint8_t* palette_remap)
+{
+    std::vector<uint64_t> new_data((m_size * new_bits + 63) / 64, 0);
+    uint64_t new_mask = (uint64_t(1) << new_bits) - 1;
+
+    // Rewrite every entry at the new bit width, optionally moving it to a new palette index
+    if (m_bits > 0)
+    {
+        for (size_t i = 0; i < m_size; i++)
+        {
+            size_t old_bit = i * m_bits;
+            uint64_t palette_index = (m_data[old_bit >> 6] >> (old_bit & 63)) & m_mask;
+            if (palette_remap) palette_index = palette_remap[palette_index];
+
+            size_t new_bit = i * new_bits;
+            new_data[new_bit >> 6] |= palette_index << (new_bit & 63);
+        }
+    }
+
+    m_bits = new_bits;
+    m_mask = new_mask;
+    m_data.swap(new_data);
+}
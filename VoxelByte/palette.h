@@ -0,0 +1,58 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Bit-packed voxel ids backed by a small palette. Every entry stores an index into the palette
+// using 0, 1, 2, 4 or 8 bits, so storage grows only as new ids are written.
+class PaletteStorage
+{
+public:
+    PaletteStorage(size_t voxel_count, uint8_t fill_id = 0);
+
+    uint8_t Get(size_t index) const;
+    // Get without the range check, for callers that already know index < GetSize()
+    inline uint8_t GetUnchecked(size_t index) const;
+    void Set(size_t index, uint8_t id);
+    void Fill(uint8_t id);
+    // Unpacks all GetSize() ids into out
+    void Decode(uint8_t* out) const;
+    // Replaces every entry with the GetSize() ids in, packed at the narrowest width that holds them
+    void Encode(const uint8_t* in);
+    // Drops palette entries that are no longer referenced and narrows the bit width to match
+    void Optimize();
+    // Appends the bit width, palette and packed words to out
+    void Serialize(std::vector<uint8_t>& out) const;
+    // Reads what Serialize wrote for a storage of the same size and advances data past it. Returns false
+    //   and leaves the storage unchanged if the bytes don't describe one.
+    bool Deserialize(const uint8_t*& data, const uint8_t* end);
+
+    size_t GetSize() const;
+    bool IsUniform() const;
+    int GetBitsPerVoxel() const;
+    size_t GetPaletteSize() const;
+    size_t GetMemoryUsage() const;
+
+private:
+    size_t m_size;
+    int m_bits = 0;
+    uint64_t m_mask = 0;
+    std::vector<uint8_t> m_palette;
+    std::vector<uint64_t> m_data;
+
+    int find_palette_index(uint8_t id) const;
+    void repack(int new_bits, const uint8_t* palette_remap);
+};
+
+uint8_t PaletteStorage::GetUnchecked(size_t index) const
+{
+    if (m_bits == 0) return m_palette[0];
+
+    // Bit widths are powers of two, so an entry never straddles two words
+    size_t bit = index * m_bits;
+    return m_palette[(m_data[bit >> 6] >> (bit & 63)) & m_mask];
+}
+
+#endif
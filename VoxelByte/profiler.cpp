@@ -0,0 +1,121 @@
+#include "globals.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <unistd.h>
+#include <fstream>
+#endif
+
+Profiler::Profiler()
+{
+    VB::inst().GetLogger()->Print("Profiler obj constructed");
+}
+
+void Profiler::Update()
+{
+    if (!m_benchmark_running) return;
+
+    double delta_time = VB::inst().GetClock()->GetDeltaTime();
+
+    // The first frame's delta includes whatever happened before the button was pressed
+    if (m_benchmark_frames > 0)
+    {
+        m_benchmark_time += delta_time;
+        m_running_result.worst_frame_ms = std::max(m_running_result.worst_frame_ms, delta_time * 1000.0);
+    }
+    m_benchmark_frames++;
+
+    m_running_result.peak_rss = std::max(m_running_result.peak_rss, GetCurrentRSS());
+
+    if (m_benchmark_time >= BENCHMARK_DURATION)
+    {
+        StopCameraPathBenchmark();
+        return;
+    }
+
+    update_camera_path();
+}
+
+size_t Profiler::GetCurrentRSS()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<size_t>(counters.WorkingSetSize);
+    return 0;
+#else
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) return 0;
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+void Profiler::StartCameraPathBenchmark()
+{
+    if (m_benchmark_running) return;
+
+    m_benchmark_running = true;
+    m_benchmark_start = VB::inst().GetCamera()->Position;
+    m_benchmark_time = 0.0;
+    m_benchmark_frames = 0;
+    m_benchmark_start_chunks = VB::inst().GetMultiChunkSystem()->GetTotalChunksLoaded();
+    m_running_result = BenchmarkResult();
+
+    VB::inst().GetLogger()->Print("Camera path benchmark started");
+}
+
+void Profiler::StopCameraPathBenchmark()
+{
+    if (!m_benchmark_running) return;
+    m_benchmark_running = false;
+
+    m_running_result.valid = true;
+    m_running_result.duration = m_benchmark_time;
+    m_running_result.chunks_loaded = VB::inst().GetMultiChunkSystem()->GetTotalChunksLoaded() - m_benchmark_start_chunks;
+    if (m_benchmark_time > 0.0)
+        m_running_result.chunks_per_sec = static_cast<double>(m_running_result.chunks_loaded) / m_benchmark_time;
+    if (m_benchmark_frames > 1)
+        m_running_result.avg_frame_ms = m_benchmark_time * 1000.0 / static_cast<double>(m_benchmark_frames - 1);
+
+    m_last_result = m_running_result;
+
+    VB::inst().GetLogger()->Print("Camera path benchmark: " + std::to_string(m_last_result.duration) + " s, "
+        + std::to_string(m_last_result.chunks_per_sec) + " chunks/s, worst frame "
+        + std::to_string(m_last_result.worst_frame_ms) + " ms, peak RSS "
+        + std::to_string(m_last_result.peak_rss / (1024 * 1024)) + " MiB");
+}
+
+bool Profiler::IsBenchmarkRunning() const
+{
+    return m_benchmark_running;
+}
+
+const Profiler::BenchmarkResult& Profiler::GetLastBenchmark() const
+{
+    return m_last_result;
+}
+
+void Profiler::update_camera_path()
+{
+    // Fly along +X at full GUI speed while weaving slowly along Z, always facing the direction of travel
+    float t = static_cast<float>(m_benchmark_time);
+    float weave_amplitude = 512.0f;
+    float weave_rate = 0.2f;
+
+    glm::vec3 position = m_benchmark_start;
+    position.x += BENCHMARK_SPEED * t;
+    position.z += weave_amplitude * std::sin(t * weave_rate);
+
+    glm::vec2 velocity(BENCHMARK_SPEED, weave_amplitude * weave_rate * std::cos(t * weave_rate));
+
+    VB::inst().GetCamera()->Position = position;
+    VB::inst().GetCamera()->SetOrientation(glm::degrees(std::atan2(velocity.y, velocity.x)), -10.0f);
+}
@@ -0,0 +1,51 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+class Profiler
+{
+public:
+    Profiler();
+
+    // Called once per frame after the clock has ticked
+    void Update();
+
+    size_t GetCurrentRSS();
+
+    // Scripted camera flight used to measure chunk streaming
+    void StartCameraPathBenchmark();
+    void StopCameraPathBenchmark();
+    bool IsBenchmarkRunning() const;
+
+    struct BenchmarkResult
+    {
+        bool valid = false;
+        double duration = 0.0;
+        double worst_frame_ms = 0.0;
+        double avg_frame_ms = 0.0;
+        double chunks_per_sec = 0.0;
+        size_t chunks_loaded = 0;
+        size_t peak_rss = 0;
+    };
+
+    const BenchmarkResult& GetLastBenchmark() const;
+
+    static constexpr double BENCHMARK_DURATION = 60.0;
+    static constexpr float BENCHMARK_SPEED = 1000.0f;
+
+private:
+    bool m_benchmark_running = false;
+    glm::vec3 m_benchmark_start;
+    double m_benchmark_time = 0.0;
+    size_t m_benchmark_frames = 0;
+    size_t m_benchmark_start_chunks = 0;
+
+    BenchmarkResult m_running_result;
+    BenchmarkResult m_last_result;
+
+    void update_camera_path();
+};
+
+#endif
@@ -0,0 +1,487 @@
+#include "globals.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char REGION_MAGIC[4] = { 'V', 'B', 'R', 'G' };
+
+static uint64_t nanoseconds_since(std::chrono::steady_clock::time_point start)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+// ----------<[ REGIONFILE CLASS IMPLEMENTATION ]>----------
+RegionFile::RegionFile(const std::filesystem::path& path)
+    : m_path(path)
+{
+    load_table();
+}
+
+RegionFile::~RegionFile()
+{
+    unmap();
+}
+
+bool RegionFile::Has(int slot) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_table[slot].size > 0;
+}
+
+bool RegionFile::Read(int slot, const std::function<bool(const uint8_t*, size_t)>& reader)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        const TableEntry& entry = m_table[slot];
+        if (entry.size == 0) return false;
+        if (m_mapping != nullptr) return reader(m_mapping + entry.offset, entry.size);
+    }
+
+    // First read since the file was opened or last written, map it and read while still holding the lock
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    const TableEntry& entry = m_table[slot];
+    if (entry.size == 0) return false;
+    if (m_mapping == nullptr && !map()) return false;
+    if (static_cast<size_t>(entry.offset) + entry.size > m_mapping_size) return false;
+    return reader(m_mapping + entry.offset, entry.size);
+}
+
+bool RegionFile::Write(int slot, const uint8_t* payload, size_t size)
+{
+    return Write({ SlotWrite{ slot, payload, size } });
+}
+
+bool RegionFile::Write(const std::vector<SlotWrite>& writes)
+{
+    if (writes.empty()) return true;
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    // The mapping would go stale (and on Windows keeps the file from growing), the next read remaps
+    unmap();
+
+    std::error_code error;
+    if (m_file_size < HEADER_SIZE)
+    {
+        // Missing or unreadable, start it over with an empty table
+        std::filesystem::create_directories(m_path.parent_path(), error);
+        std::ofstream create(m_path, std::ios::binary | std::ios::trunc);
+        uint32_t version = VERSION;
+        create.write(REGION_MAGIC, sizeof(REGION_MAGIC));
+        create.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        std::vector<char> empty_table(SLOT_COUNT * sizeof(TableEntry), 0);
+        create.write(empty_table.data(), empty_table.size());
+        if (!create)
+        {
+            VB::inst().GetLogger()->PrintErr("Failed to create region file " + m_path.string());
+            return false;
+        }
+
+        m_table.fill(TableEntry());
+        m_file_size = HEADER_SIZE;
+    }
+
+    std::fstream file(m_path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file)
+    {
+        VB::inst().GetLogger()->PrintErr("Failed to open region file " + m_path.string());
+        return false;
+    }
+
+    // Free space is whatever no table entry covers. The batch's own slots still hold their old payloads
+    //   here, so nothing of what the table points at on disk gets overwritten before the table moves on.
+    std::vector<std::pair<size_t, size_t>> used;
+    for (const TableEntry& entry : m_table)
+        if (entry.size > 0) used.push_back({ entry.offset, static_cast<size_t>(entry.offset) + entry.capacity });
+    std::sort(used.begin(), used.end());
+
+    std::vector<std::pair<size_t, size_t>> gaps;
+    size_t gap_start = HEADER_SIZE;
+    for (const auto& extent : used)
+    {
+        if (extent.first > gap_start) gaps.push_back({ gap_start, extent.first });
+        gap_start = std::max(gap_start, extent.second);
+    }
+    if (m_file_size > gap_start) gaps.push_back({ gap_start, m_file_size });
+
+    // Every payload goes to the first gap it fits, or the end of the file
+    std::array<TableEntry, SLOT_COUNT> table = m_table;
+    size_t file_size = m_file_size;
+    std::vector<char> padded;
+    for (const SlotWrite& write : writes)
+    {
+        TableEntry& entry = table[write.slot];
+        entry.size = static_cast<uint32_t>(write.size);
+        entry.capacity = static_cast<uint32_t>((write.size + CAPACITY_GRANULARITY - 1) / CAPACITY_GRANULARITY * CAPACITY_GRANULARITY);
+
+        auto gap = std::find_if(gaps.begin(), gaps.end(), [&entry](const std::pair<size_t, size_t>& g) { return g.second - g.first >= entry.capacity; });
+        if (gap != gaps.end())
+        {
+            entry.offset = static_cast<uint32_t>(gap->first);
+            gap->first += entry.capacity;
+        }
+        else
+        {
+            entry.offset = static_cast<uint32_t>(file_size);
+            file_size += entry.capacity;
+        }
+
+        // Padded out to the capacity so the file always reaches past the last extent
+        padded.assign(entry.capacity, 0);
+        std::memcpy(padded.data(), write.payload, write.size);
+        file.seekp(entry.offset);
+        file.write(padded.data(), padded.size());
+    }
+
+    // Only once every payload is out do the table entries switch over to them
+    file.flush();
+    if (!file)
+    {
+        VB::inst().GetLogger()->PrintErr("Failed to write region file " + m_path.string());
+        return false;
+    }
+
+    for (const SlotWrite& write : writes)
+    {
+        file.seekp(8 + write.slot * sizeof(TableEntry));
+        file.write(reinterpret_cast<const char*>(&table[write.slot]), sizeof(TableEntry));
+    }
+
+    file.flush();
+    if (!file)
+    {
+        // Some entries may have made it to disk, take the table back from there so the space they point at
+        //   isn't handed out again
+        VB::inst().GetLogger()->PrintErr("Failed to write region file table " + m_path.string());
+        file.close();
+        load_table();
+        return false;
+    }
+
+    m_table = table;
+    m_file_size = file_size;
+    return true;
+}
+
+const std::filesystem::path& RegionFile::GetPath() const
+{
+    return m_path;
+}
+
+size_t RegionFile::GetFileSize() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_file_size;
+}
+
+bool RegionFile::map()
+{
+    if (m_file_size < HEADER_SIZE) return false;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(m_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER file_size;
+    HANDLE mapping = GetFileSizeEx(file, &file_size) ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    const void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr)
+    {
+        if (mapping != nullptr) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file_handle = file;
+    m_mapping_handle = mapping;
+    m_mapping = static_cast<const uint8_t*>(view);
+    m_mapping_size = static_cast<size_t>(file_size.QuadPart);
+#else
+    int descriptor = open(m_path.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+
+    struct stat file_stat;
+    void* view = fstat(descriptor, &file_stat) == 0 && file_stat.st_size > 0
+        ? mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_SHARED, descriptor, 0)
+        : MAP_FAILED;
+    if (view == MAP_FAILED)
+    {
+        close(descriptor);
+        return false;
+    }
+
+    m_file_descriptor = descriptor;
+    m_mapping = static_cast<const uint8_t*>(view);
+    m_mapping_size = static_cast<size_t>(file_stat.st_size);
+#endif
+    return true;
+}
+
+void RegionFile::unmap()
+{
+    if (m_mapping == nullptr) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_mapping);
+    CloseHandle(static_cast<HANDLE>(m_mapping_handle));
+    CloseHandle(static_cast<HANDLE>(m_file_handle));
+    m_mapping_handle = nullptr;
+    m_file_handle = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(m_mapping), m_mapping_size);
+    close(m_file_descriptor);
+    m_file_descriptor = -1;
+#endif
+    m_mapping = nullptr;
+    m_mapping_size = 0;
+}
+
+void RegionFile::load_table()
+{
+    m_table.fill(TableEntry());
+    m_file_size = 0;
+
+    std::ifstream file(m_path, std::ios::binary | std::ios::ate);
+    if (!file) return;
+
+    size_t file_size = static_cast<size_t>(file.tellg());
+    if (file_size < HEADER_SIZE) return;
+
+    char magic[4];
+    uint32_t version;
+    file.seekg(0);
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(m_table.data()), SLOT_COUNT * sizeof(TableEntry));
+    if (!file || std::memcmp(magic, REGION_MAGIC, sizeof(magic)) != 0 || version != VERSION)
+    {
+        VB::inst().GetLogger()->PrintErr("Ignoring unreadable region file " + m_path.string());
+        m_table.fill(TableEntry());
+        return;
+    }
+
+    // Entries pointing outside the file (a write cut short) are dropped, the chunk is regenerated
+    for (TableEntry& entry : m_table)
+        if (entry.offset < HEADER_SIZE || static_cast<size_t>(entry.offset) + entry.size > file_size || entry.size > entry.capacity)
+            entry = TableEntry();
+
+    m_file_size = file_size;
+}
+
+// ----------<[ REGIONSTORE CLASS IMPLEMENTATION ]>----------
+RegionStore::RegionStore()
+{
+    VB::inst().GetLogger()->Print("RegionStore obj constructed");
+}
+
+RegionStore::~RegionStore()
+{
+    CloseAll();
+}
+
+bool RegionStore::LoadChunk(Chunk& chunk)
+{
+    glm::ivec3 chunk_idx = UnpackChunkID(chunk.GetChunkID());
+    std::shared_ptr<RegionFile> region = get_region(ChunkToRegionIdx(chunk_idx));
+
+    auto start = std::chrono::steady_clock::now();
+    size_t payload_size = 0;
+    bool loaded = region->Read(ChunkToRegionSlot(chunk_idx), [&](const uint8_t* payload, size_t size)
+    {
+        payload_size = size;
+        return chunk.Deserialize(payload, size);
+    });
+
+    if (!loaded)
+    {
+        if (payload_size > 0) VB::inst().GetLogger()->PrintErr("Corrupt chunk " + std::to_string(chunk.GetChunkID()) + " in " + region->GetPath().string() + ", regenerating");
+        return false;
+    }
+
+    m_load_nanoseconds += nanoseconds_since(start);
+    m_bytes_read += payload_size;
+    m_chunks_loaded++;
+    return true;
+}
+
+void RegionStore::SaveChunk(Chunk& chunk)
+{
+    glm::ivec3 chunk_idx = UnpackChunkID(chunk.GetChunkID());
+    std::vector<uint8_t> payload;
+    chunk.Serialize(payload);
+    if (WriteChunks(ChunkToRegionIdx(chunk_idx), { RegionFile::SlotWrite{ ChunkToRegionSlot(chunk_idx), payload.data(), payload.size() } }))
+        chunk.ClearDirty();
+}
+
+bool RegionStore::WriteChunks(const glm::ivec3& region_idx, const std::vector<RegionFile::SlotWrite>& writes)
+{
+    std::shared_ptr<RegionFile> region = get_region(region_idx);
+
+    auto start = std::chrono::steady_clock::now();
+    if (!region->Write(writes)) return false;
+
+    m_save_nanoseconds += nanoseconds_since(start);
+    for (const RegionFile::SlotWrite& write : writes) m_bytes_written += write.size;
+    m_chunks_saved += writes.size();
+    return true;
+}
+
+bool RegionStore::HasChunk(const ChunkID& chunk_id)
+{
+    glm::ivec3 chunk_idx = UnpackChunkID(chunk_id);
+    return get_region(ChunkToRegionIdx(chunk_idx))->Has(ChunkToRegionSlot(chunk_idx));
+}
+
+void RegionStore::CloseAll()
+{
+    std::lock_guard<std::mutex> lock(m_region_mutex);
+    m_regions.Clear();
+    m_region_order.clear();
+}
+
+void RegionStore::SetSaveDirectory(const std::filesystem::path& directory)
+{
+    CloseAll();
+    m_save_directory = directory;
+}
+
+std::filesystem::path RegionStore::GetWorldDirectory() const
+{
+    return m_save_directory / ("seed_" + std::to_string(VB::inst().GetNoiseGenerator()->GetSeed()));
+}
+
+glm::ivec3 RegionStore::ChunkToRegionIdx(const glm::ivec3& chunk_idx)
+{
+    // Regions are REGION_SIZE chunks wide in x and z and one chunk tall, floor division for negative indices
+    return glm::ivec3(chunk_idx.x >> 5, chunk_idx.y, chunk_idx.z >> 5);
+}
+
+int RegionStore::ChunkToRegionSlot(const glm::ivec3& chunk_idx)
+{
+    return (chunk_idx.x & (RegionFile::REGION_SIZE - 1)) * RegionFile::REGION_SIZE + (chunk_idx.z & (RegionFile::REGION_SIZE - 1));
+}
+
+RegionStore::Stats RegionStore::GetStats() const
+{
+    Stats stats;
+    stats.chunks_loaded = static_cast<size_t>(m_chunks_loaded.load());
+    stats.chunks_saved = static_cast<size_t>(m_chunks_saved.load());
+    stats.bytes_read = static_cast<size_t>(m_bytes_read.load());
+    stats.bytes_written = static_cast<size_t>(m_bytes_written.load());
+    stats.load_seconds = m_load_nanoseconds.load() * 1e-9;
+    stats.save_seconds = m_save_nanoseconds.load() * 1e-9;
+
+    std::lock_guard<std::mutex> lock(m_region_mutex);
+    stats.open_regions = m_regions.Size();
+    return stats;
+}
+
+const RegionStore::BenchmarkResult& RegionStore::RunBenchmark(int chunks_per_axis)
+{
+    BenchmarkResult result;
+    result.valid = true;
+
+    // Region aligned, so each layer of the block is one file
+    const glm::ivec3 base_idx(4096, -2, 4096);
+    const int per_axis = std::min(chunks_per_axis, RegionFile::REGION_SIZE);
+    const std::filesystem::path directory = m_save_directory / "benchmark";
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    {
+        std::vector<std::unique_ptr<RegionFile>> layers;
+        for (int y = 0; y < per_axis; y++)
+            layers.push_back(std::make_unique<RegionFile>(directory / ("r.benchmark." + std::to_string(y) + ".vbr")));
+
+        std::vector<uint64_t> hashes;
+        std::vector<uint8_t> payload;
+        for (int x = 0; x < per_axis; x++)
+        for (int y = 0; y < per_axis; y++)
+        for (int z = 0; z < per_axis; z++)
+        {
+            glm::ivec3 chunk_idx = base_idx + glm::ivec3(x, y, z);
+            Chunk chunk(PackChunkID(chunk_idx), chunk_idx * Chunk::CHUNK_SIZE);
+
+            auto start = std::chrono::steady_clock::now();
+            chunk.GenerateChunk();
+            result.generate_seconds += nanoseconds_since(start) * 1e-9;
+            hashes.push_back(chunk.GetContentHash());
+
+            start = std::chrono::steady_clock::now();
+            payload.clear();
+            chunk.Serialize(payload);
+            layers[y]->Write(ChunkToRegionSlot(chunk_idx), payload.data(), payload.size());
+            result.save_seconds += nanoseconds_since(start) * 1e-9;
+            result.payload_bytes += payload.size();
+            result.chunks++;
+        }
+
+        size_t i = 0;
+        for (int x = 0; x < per_axis; x++)
+        for (int y = 0; y < per_axis; y++)
+        for (int z = 0; z < per_axis; z++)
+        {
+            glm::ivec3 chunk_idx = base_idx + glm::ivec3(x, y, z);
+            Chunk chunk(PackChunkID(chunk_idx), chunk_idx * Chunk::CHUNK_SIZE);
+
+            auto start = std::chrono::steady_clock::now();
+            bool loaded = layers[y]->Read(ChunkToRegionSlot(chunk_idx), [&](const uint8_t* data, size_t size) { return chunk.Deserialize(data, size); });
+            result.load_seconds += nanoseconds_since(start) * 1e-9;
+
+            if (!loaded || chunk.GetContentHash() != hashes[i]) result.mismatched_chunks++;
+            i++;
+        }
+    }
+    std::filesystem::remove_all(directory, error);
+
+    m_last_benchmark = result;
+    VB::inst().GetLogger()->Print("Region benchmark: " + std::to_string(result.chunks) + " chunks, generate " + std::to_string(result.generate_seconds * 1000.0) +
+                                  " ms, load " + std::to_string(result.load_seconds * 1000.0) + " ms, " + std::to_string(result.mismatched_chunks) + " mismatched");
+    return m_last_benchmark;
+}
+
+const RegionStore::BenchmarkResult& RegionStore::GetLastBenchmark() const
+{
+    return m_last_benchmark;
+}
+
+std::shared_ptr<RegionFile> RegionStore::get_region(const glm::ivec3& region_idx)
+{
+    ChunkID key = PackChunkID(region_idx);
+
+    std::lock_guard<std::mutex> lock(m_region_mutex);
+    std::shared_ptr<RegionFile>& region = m_regions[key];
+    if (region != nullptr) return region;
+
+    std::string name = "r." + std::to_string(region_idx.x) + "." + std::to_string(region_idx.y) + "." + std::to_string(region_idx.z) + ".vbr";
+    region = std::make_shared<RegionFile>(GetWorldDirectory() / name);
+    std::shared_ptr<RegionFile> opened = region;
+
+    m_region_order.push_back(key);
+    if (m_region_order.size() > MAX_OPEN_REGIONS)
+    {
+        // References are only handed out under m_region_mutex, so a count of one can't go back up
+        for (auto it = m_region_order.begin(); it != m_region_order.end(); ++it)
+        {
+            if (m_regions.Find(*it)->use_count() > 1) continue;
+
+            m_regions.Erase(*it);
+            m_region_order.erase(it);
+            break;
+        }
+    }
+    return opened;
+}
@@ -0,0 +1,166 @@
+#ifndef REGION_H
+#define REGION_H
+
+#include "voxel.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+// One file holding up to REGION_SIZE x REGION_SIZE chunks of a single chunk layer. Layout (little endian):
+//   "VBRG", u32 version, then REGION_SIZE^2 table entries of { u32 offset, u32 size, u32 capacity }, then
+//   payloads. Payloads never overwrite the one a slot already points at: each write goes to space no
+//   table entry covers, a gap left by earlier rewrites or the end of the file, and the slot's entry is
+//   switched over after it, so a write cut short leaves the slot on its old payload.
+//   Reads come straight out of a read-only memory mapping, which writes drop and the next read remaps.
+class RegionFile
+{
+public:
+    static constexpr int REGION_SIZE = 32;
+    static constexpr int SLOT_COUNT = REGION_SIZE * REGION_SIZE;
+
+    struct SlotWrite
+    {
+        int slot;
+        const uint8_t* payload;
+        size_t size;
+    };
+
+    explicit RegionFile(const std::filesystem::path& path);
+    ~RegionFile();
+
+    RegionFile(const RegionFile&) = delete;
+    RegionFile& operator=(const RegionFile&) = delete;
+
+    bool Has(int slot) const;
+    // Hands the slot's payload to reader without copying it and returns what reader does, or false if the
+    //   slot has never been written. The pointer is only valid during the call.
+    bool Read(int slot, const std::function<bool(const uint8_t*, size_t)>& reader);
+    // Returns false (and logs) if the file couldn't be written, the slot then keeps its old payload
+    bool Write(int slot, const uint8_t* payload, size_t size);
+    // Writes several slots through one open of the file, all payloads first and then their table entries.
+    //   On failure each slot reads back either its old or its new payload, never a mix, and false is
+    //   returned so the caller can write it again. Each slot should appear at most once.
+    bool Write(const std::vector<SlotWrite>& writes);
+
+    const std::filesystem::path& GetPath() const;
+    size_t GetFileSize() const;
+
+private:
+    struct TableEntry
+    {
+        uint32_t offset = 0;
+        uint32_t size = 0;
+        uint32_t capacity = 0;
+    };
+
+    static const uint32_t VERSION = 1;
+    static const size_t HEADER_SIZE = 8 + SLOT_COUNT * sizeof(TableEntry);
+    // Payload capacities are rounded up to this, so the gaps rewrites leave behind fit other chunks' payloads
+    static const uint32_t CAPACITY_GRANULARITY = 256;
+
+    std::filesystem::path m_path;
+    // Shared for reads through the mapping, exclusive to (re)map or write
+    mutable std::shared_mutex m_mutex;
+    std::array<TableEntry, SLOT_COUNT> m_table;
+    size_t m_file_size = 0;
+
+    const uint8_t* m_mapping = nullptr;
+    size_t m_mapping_size = 0;
+#ifdef _WIN32
+    void* m_file_handle = nullptr;
+    void* m_mapping_handle = nullptr;
+#else
+    int m_file_descriptor = -1;
+#endif
+
+    bool map();
+    void unmap();
+    void load_table();
+};
+
+// Saved chunks, one directory of region files per world seed. Loads run on the generation workers, saves on
+//   the ChunkIOService thread.
+class RegionStore
+{
+public:
+    static const size_t MAX_OPEN_REGIONS = 64;
+
+    RegionStore();
+    ~RegionStore();
+
+    // Fills chunk from disk and returns true if it was saved before
+    bool LoadChunk(Chunk& chunk);
+    // Writes the chunk out and clears its dirty flag. Different chunks can be saved from different threads.
+    void SaveChunk(Chunk& chunk);
+    // Writes already serialized chunks that all live in the region at region_idx, as one batch
+    bool WriteChunks(const glm::ivec3& region_idx, const std::vector<RegionFile::SlotWrite>& writes);
+    bool HasChunk(const ChunkID& chunk_id);
+    // Unmaps and closes every region file
+    void CloseAll();
+
+    // Parent of the per-seed directories. Only change it before any chunk is loaded or saved.
+    void SetSaveDirectory(const std::filesystem::path& directory);
+    std::filesystem::path GetWorldDirectory() const;
+
+    static glm::ivec3 ChunkToRegionIdx(const glm::ivec3& chunk_idx);
+    static int ChunkToRegionSlot(const glm::ivec3& chunk_idx);
+
+    struct Stats
+    {
+        size_t chunks_loaded = 0;
+        size_t chunks_saved = 0;
+        size_t bytes_read = 0;
+        size_t bytes_written = 0;
+        double load_seconds = 0.0;
+        double save_seconds = 0.0;
+        size_t open_regions = 0;
+    };
+    Stats GetStats() const;
+
+    struct BenchmarkResult
+    {
+        bool valid = false;
+        size_t chunks = 0;
+        size_t payload_bytes = 0;
+        double generate_seconds = 0.0;
+        double save_seconds = 0.0;
+        double load_seconds = 0.0;
+        // Chunks whose content hash changed across the save / load round trip
+        size_t mismatched_chunks = 0;
+    };
+    // Generates a block of chunks, saves them to a scratch directory, loads them back and compares, then
+    //   deletes the scratch files. Runs on the calling thread.
+    const BenchmarkResult& RunBenchmark(int chunks_per_axis = 4);
+    const BenchmarkResult& GetLastBenchmark() const;
+
+private:
+    std::filesystem::path m_save_directory = "saves";
+
+    mutable std::mutex m_region_mutex;
+    ChunkMap<std::shared_ptr<RegionFile>> m_regions;
+    // Open order, the oldest region nobody is using is closed once more than MAX_OPEN_REGIONS are open.
+    //   Closing one that is still in use would let a second RegionFile open the same file.
+    std::deque<ChunkID> m_region_order;
+
+    std::atomic<uint64_t> m_chunks_loaded{ 0 };
+    std::atomic<uint64_t> m_chunks_saved{ 0 };
+    std::atomic<uint64_t> m_bytes_read{ 0 };
+    std::atomic<uint64_t> m_bytes_written{ 0 };
+    std::atomic<uint64_t> m_load_nanoseconds{ 0 };
+    std::atomic<uint64_t> m_save_nanoseconds{ 0 };
+
+    BenchmarkResult m_last_benchmark;
+
+    std::shared_ptr<RegionFile> get_region(const glm::ivec3& region_idx);
+};
+
+#endif
@@ -0,0 +1,479 @@
+#include "globals.h"
+
+#include <chrono>
+#include <climits>
+#include <cmath>
+
+static const int COLUMN_AREA = Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE;
+static const int CHUNK_VOLUME = Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE;
+static const int CAVE_LATTICE = Chunk::CHUNK_SIZE / TerrainGenerator::CAVE_STEP + 1;
+
+static const uint8_t VOXEL_AIR = 0;
+static const uint8_t VOXEL_GRASS = 1;
+static const uint8_t VOXEL_DIRT = 2;
+static const uint8_t VOXEL_STONE = 3;
+static const uint8_t VOXEL_SAND = 4;
+static const uint8_t VOXEL_SNOW = 5;
+
+static void add_time(TerrainGenerator::StageStats& stats, std::chrono::steady_clock::time_point start)
+{
+    stats.runs++;
+    stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ----------<[ TERRAINGENERATOR CLASS IMPLEMENTATION ]>----------
+TerrainGenerator::TerrainGenerator()
+{
+    ResetStageTimings();
+    VB::inst().GetLogger()->Print("TerrainGenerator obj constructed");
+}
+
+void TerrainGenerator::GenerateChunk(Chunk& chunk)
+{
+    Settings settings;
+    uint32_t settings_version;
+    {
+        std::lock_guard<std::mutex> lock(m_column_mutex);
+        settings = m_settings;
+        settings_version = m_settings_version;
+    }
+
+    StageTimings timings;
+    generate_chunk(chunk, VB::inst().GetNoiseGenerator()->GetSeed(), settings, settings_version, true, timings);
+    add_stage_timings(timings);
+}
+
+const TerrainGenerator::Settings& TerrainGenerator::GetSettings() const
+{
+    return m_settings;
+}
+
+void TerrainGenerator::SetSettings(const Settings& settings)
+{
+    std::lock_guard<std::mutex> lock(m_column_mutex);
+    m_settings = settings;
+    m_settings_version++;
+    m_columns.Clear();
+    m_column_order.clear();
+}
+
+const char* TerrainGenerator::GetBiomeName(Biome biome)
+{
+    switch (biome)
+    {
+    case BIOME_PLAINS: return "Plains";
+    case BIOME_DESERT: return "Desert";
+    case BIOME_MOUNTAINS: return "Mountains";
+    default: return "Unknown";
+    }
+}
+
+const char* TerrainGenerator::GetStageName(Stage stage)
+{
+    switch (stage)
+    {
+    case STAGE_COLUMNS: return "Columns";
+    case STAGE_STRATA: return "Strata";
+    case STAGE_CAVES: return "Caves";
+    case STAGE_STORE: return "Store";
+    default: return "Unknown";
+    }
+}
+
+TerrainGenerator::StageTimings TerrainGenerator::GetStageTimings() const
+{
+    StageTimings timings;
+    for (int stage = 0; stage < STAGE_COUNT; stage++)
+    {
+        timings[stage].runs = static_cast<size_t>(m_stage_runs[stage].load());
+        timings[stage].seconds = m_stage_nanoseconds[stage].load() * 1e-9;
+    }
+    return timings;
+}
+
+void TerrainGenerator::ResetStageTimings()
+{
+    for (int stage = 0; stage < STAGE_COUNT; stage++)
+    {
+        m_stage_runs[stage] = 0;
+        m_stage_nanoseconds[stage] = 0;
+    }
+    m_column_hits = 0;
+    m_column_misses = 0;
+}
+
+size_t TerrainGenerator::GetColumnCacheHits() const
+{
+    return static_cast<size_t>(m_column_hits.load());
+}
+
+size_t TerrainGenerator::GetColumnCacheMisses() const
+{
+    return static_cast<size_t>(m_column_misses.load());
+}
+
+const TerrainGenerator::BenchmarkResult& TerrainGenerator::RunBenchmark(int columns_per_axis, int layers)
+{
+    Settings settings;
+    {
+        std::lock_guard<std::mutex> lock(m_column_mutex);
+        settings = m_settings;
+    }
+    const int seed = VB::inst().GetNoiseGenerator()->GetSeed();
+
+    BenchmarkResult result;
+    result.valid = true;
+
+    // Far from where the camera starts, and built without the cache so every column is computed once
+    const glm::ivec3 base_idx(4096, -1, 4096);
+
+    auto benchmark_start = std::chrono::steady_clock::now();
+    for (int cx = 0; cx < columns_per_axis; cx++)
+    {
+        for (int cz = 0; cz < columns_per_axis; cz++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            std::shared_ptr<const Column> column = build_column(glm::ivec2(base_idx.x + cx, base_idx.z + cz) * Chunk::CHUNK_SIZE, seed, settings);
+            add_time(result.stages[STAGE_COLUMNS], start);
+
+            for (int layer = 0; layer < layers; layer++)
+            {
+                glm::ivec3 chunk_idx(base_idx.x + cx, base_idx.y + layer, base_idx.z + cz);
+                Chunk chunk(PackChunkID(chunk_idx), chunk_idx * Chunk::CHUNK_SIZE);
+                generate_voxels(chunk, *column, settings, result.stages);
+                result.chunks++;
+            }
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - benchmark_start).count();
+
+    m_last_benchmark = result;
+    VB::inst().GetLogger()->Print("Terrain benchmark: " + std::to_string(result.chunks) + " chunks in " + std::to_string(result.seconds * 1000.0) + " ms");
+    return m_last_benchmark;
+}
+
+const TerrainGenerator::BenchmarkResult& TerrainGenerator::GetLastBenchmark() const
+{
+    return m_last_benchmark;
+}
+
+const TerrainGenerator::DeterminismResult& TerrainGenerator::RunDeterminismCheck(int seed)
+{
+    Settings settings;
+    uint32_t settings_version;
+    {
+        std::lock_guard<std::mutex> lock(m_column_mutex);
+        settings = m_settings;
+        settings_version = m_settings_version;
+    }
+
+    DeterminismResult result;
+    result.valid = true;
+    result.seed = seed;
+    // A pool of its own, sized like the shared one, so waiting on the check never waits on streaming
+    //   or meshing jobs queued there
+    ThreadPool pool(VB::inst().GetThreadPool()->GetThreadCount());
+    result.threads = pool.GetThreadCount();
+
+    // Spans the surface and a few cave layers below it, away from the loaded world
+    const glm::ivec3 base_idx(-4096, -2, -4096);
+    const glm::ivec3 block_size(4, 4, 4);
+
+    std::vector<glm::ivec3> chunk_indices;
+    for (int x = 0; x < block_size.x; x++)
+        for (int y = 0; y < block_size.y; y++)
+            for (int z = 0; z < block_size.z; z++)
+                chunk_indices.push_back(base_idx + glm::ivec3(x, y, z));
+    result.chunks = chunk_indices.size();
+
+    std::vector<uint64_t> single_hashes(chunk_indices.size());
+    for (size_t i = 0; i < chunk_indices.size(); i++)
+    {
+        Chunk chunk(PackChunkID(chunk_indices[i]), chunk_indices[i] * Chunk::CHUNK_SIZE);
+        StageTimings timings;
+        generate_chunk(chunk, seed, settings, settings_version, false, timings);
+        single_hashes[i] = chunk.GetContentHash();
+    }
+
+    // Backwards, so workers build columns in a different order than the pass above and race on the cache
+    std::vector<uint64_t> multi_hashes(chunk_indices.size());
+    for (size_t i = chunk_indices.size(); i-- > 0;)
+    {
+        pool.Submit([this, &chunk_indices, &multi_hashes, &settings, i, seed, settings_version]()
+        {
+            Chunk chunk(PackChunkID(chunk_indices[i]), chunk_indices[i] * Chunk::CHUNK_SIZE);
+            StageTimings timings;
+            generate_chunk(chunk, seed, settings, settings_version, true, timings);
+            multi_hashes[i] = chunk.GetContentHash();
+        });
+    }
+    pool.WaitIdle();
+
+    // Folded in index order, so the combined hash doesn't depend on which job finished first
+    result.single_thread_hash = 0xcbf29ce484222325ULL;
+    result.multi_thread_hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < chunk_indices.size(); i++)
+    {
+        result.single_thread_hash = (result.single_thread_hash ^ single_hashes[i]) * 0x100000001b3ULL;
+        result.multi_thread_hash = (result.multi_thread_hash ^ multi_hashes[i]) * 0x100000001b3ULL;
+        if (single_hashes[i] != multi_hashes[i]) result.mismatched_chunks++;
+    }
+
+    m_last_determinism_check = result;
+    VB::inst().GetLogger()->Print("Terrain determinism check (seed " + std::to_string(seed) + "): " +
+                                  std::to_string(result.mismatched_chunks) + " of " + std::to_string(result.chunks) + " chunks differ");
+    return m_last_determinism_check;
+}
+
+const TerrainGenerator::DeterminismResult& TerrainGenerator::GetLastDeterminismCheck() const
+{
+    return m_last_determinism_check;
+}
+
+void TerrainGenerator::generate_chunk(Chunk& chunk, int seed, const Settings& settings, uint32_t settings_version, bool use_cache, StageTimings& timings)
+{
+    glm::ivec3 origin = chunk.getOrigin();
+    glm::ivec2 column_origin(origin.x, origin.z);
+
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const Column> column = use_cache ? get_column(column_origin, seed, settings, settings_version) : build_column(column_origin, seed, settings);
+    add_time(timings[STAGE_COLUMNS], start);
+
+    generate_voxels(chunk, *column, settings, timings);
+}
+
+void TerrainGenerator::generate_voxels(Chunk& chunk, const Column& column, const Settings& settings, StageTimings& timings) const
+{
+    glm::ivec3 origin = chunk.getOrigin();
+
+    // Above the highest surface in the column there is only air, which a new chunk already is
+    if (origin.y > column.max_height) return;
+
+    // One buffer per worker, a whole chunk is too big for the stack
+    thread_local std::vector<uint8_t> voxels(CHUNK_VOLUME);
+
+    auto start = std::chrono::steady_clock::now();
+    fill_strata(column, origin.y, settings, voxels.data());
+    add_time(timings[STAGE_STRATA], start);
+
+    start = std::chrono::steady_clock::now();
+    carve_caves(column, origin, settings, voxels.data());
+    add_time(timings[STAGE_CAVES], start);
+
+    start = std::chrono::steady_clock::now();
+    chunk.SetVoxels(voxels.data());
+    add_time(timings[STAGE_STORE], start);
+}
+
+std::shared_ptr<const TerrainGenerator::Column> TerrainGenerator::get_column(glm::ivec2 origin, int seed, const Settings& settings, uint32_t settings_version)
+{
+    ChunkID key = PackChunkID(glm::ivec3(origin.x / Chunk::CHUNK_SIZE, 0, origin.y / Chunk::CHUNK_SIZE));
+    {
+        std::lock_guard<std::mutex> lock(m_column_mutex);
+        const std::shared_ptr<const Column>* cached = m_columns.Find(key);
+        if (cached != nullptr && (*cached)->seed == seed)
+        {
+            m_column_hits++;
+            return *cached;
+        }
+    }
+
+    // Built outside the lock, two workers on the same column may both build it and the second one is dropped
+    m_column_misses++;
+    std::shared_ptr<const Column> column = build_column(origin, seed, settings);
+
+    // Settings changed while it was being built, use it for this chunk but don't keep it
+    std::lock_guard<std::mutex> lock(m_column_mutex);
+    if (settings_version != m_settings_version) return column;
+
+    std::shared_ptr<const Column>& slot = m_columns[key];
+    if (slot != nullptr && slot->seed == seed) return slot;
+    if (slot != nullptr)
+    {
+        // Built for another seed (a determinism check), replaced in place and keeping its place in the order
+        slot = column;
+        return column;
+    }
+
+    slot = column;
+    m_column_order.push_back(key);
+    if (m_column_order.size() > MAX_CACHED_COLUMNS)
+    {
+        m_columns.Erase(m_column_order.front());
+        m_column_order.pop_front();
+    }
+    return column;
+}
+
+std::shared_ptr<const TerrainGenerator::Column> TerrainGenerator::build_column(glm::ivec2 origin, int seed, const Settings& settings) const
+{
+    const NoiseGenerator& noise = *VB::inst().GetNoiseGenerator();
+    const glm::ivec2 size(Chunk::CHUNK_SIZE);
+
+    // Each layer gets its own seed so they don't line up with each other
+    std::vector<float> layers(4 * COLUMN_AREA);
+    float* continental = layers.data();
+    float* erosion = continental + COLUMN_AREA;
+    float* detail = erosion + COLUMN_AREA;
+    float* temperature = detail + COLUMN_AREA;
+    noise.FillNoise2D(seed + 1, settings.continental_frequency, origin, size, continental);
+    noise.FillNoise2D(seed + 2, settings.erosion_frequency, origin, size, erosion);
+    noise.FillNoise2D(seed, noise.GetFrequency(), origin, size, detail);
+    noise.FillNoise2D(seed + 3, settings.temperature_frequency, origin, size, temperature);
+
+    // Drawn in column order from the column's own stream, so it's the same whichever chunk builds it
+    ChunkRandom random(seed, glm::ivec3(origin.x / Chunk::CHUNK_SIZE, 0, origin.y / Chunk::CHUNK_SIZE));
+
+    std::shared_ptr<Column> column = std::make_shared<Column>();
+    column->seed = seed;
+    column->min_height = INT_MAX;
+    column->max_height = INT_MIN;
+    for (int i = 0; i < COLUMN_AREA; i++)
+    {
+        // Erosion runs from -1 (rough) to 1 (worn flat) and scales how much the detail noise shows
+        float roughness = (1.0f - erosion[i]) * 0.5f;
+        float detail_amplitude = settings.detail_amplitude_eroded + (settings.detail_amplitude_rough - settings.detail_amplitude_eroded) * roughness;
+        float height = settings.base_height + continental[i] * settings.continental_amplitude + detail[i] * detail_amplitude;
+
+        Biome biome = BIOME_PLAINS;
+        if (erosion[i] < settings.mountain_erosion)
+        {
+            height += (settings.mountain_erosion - erosion[i]) * settings.mountain_amplitude;
+            biome = BIOME_MOUNTAINS;
+        }
+        else if (temperature[i] > settings.desert_temperature)
+        {
+            biome = BIOME_DESERT;
+        }
+
+        // Highest solid voxel, everything with y < height is ground
+        int top = static_cast<int>(std::ceil(height)) - 1;
+        column->height[i] = top;
+        column->biome[i] = biome;
+        column->extra_depth[i] = static_cast<uint8_t>(random.NextInt(static_cast<uint32_t>(settings.surface_depth_jitter) + 1));
+        column->min_height = std::min(column->min_height, top);
+        column->max_height = std::max(column->max_height, top);
+    }
+
+    return column;
+}
+
+void TerrainGenerator::fill_strata(const Column& column, int origin_y, const Settings& settings, uint8_t* voxels) const
+{
+    const int size = Chunk::CHUNK_SIZE;
+
+    // Deeper than any surface layer reaches, it's all stone
+    int deepest_layer = std::max(settings.dirt_depth, settings.sand_depth) + settings.surface_depth_jitter;
+    if (origin_y + size - 1 < column.min_height - deepest_layer)
+    {
+        std::fill(voxels, voxels + CHUNK_VOLUME, VOXEL_STONE);
+        return;
+    }
+
+    for (int x = 0; x < size; x++)
+    {
+        for (int y = 0; y < size; y++)
+        {
+            uint8_t* row = voxels + x * size * size + y * size;
+            int world_y = origin_y + y;
+
+            for (int z = 0; z < size; z++)
+            {
+                int top = column.height[x * size + z];
+                int depth = top - world_y;
+                if (depth < 0)
+                {
+                    row[z] = VOXEL_AIR;
+                    continue;
+                }
+
+                int extra_depth = column.extra_depth[x * size + z];
+                switch (column.biome[x * size + z])
+                {
+                case BIOME_DESERT:
+                    row[z] = depth < settings.sand_depth + extra_depth ? VOXEL_SAND : VOXEL_STONE;
+                    break;
+                case BIOME_MOUNTAINS:
+                    row[z] = depth == 0 && top >= settings.snow_height ? VOXEL_SNOW : VOXEL_STONE;
+                    break;
+                default:
+                    if (depth == 0) row[z] = VOXEL_GRASS;
+                    else row[z] = depth <= settings.dirt_depth + extra_depth ? VOXEL_DIRT : VOXEL_STONE;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void TerrainGenerator::carve_caves(const Column& column, glm::ivec3 origin, const Settings& settings, uint8_t* voxels) const
+{
+    if (!settings.caves) return;
+
+    // Caves stop cave_surface_margin under the surface, so lattice layers above that are never needed
+    int carve_top = column.max_height - settings.cave_surface_margin - origin.y;
+    if (carve_top < 0) return;
+    int cell_layers = std::min(CAVE_LATTICE - 1, carve_top / CAVE_STEP + 1);
+
+    FastNoiseLite cave_noise(column.seed + 4);
+    cave_noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    cave_noise.SetFrequency(settings.cave_frequency);
+
+    // Sampling every CAVE_STEP voxels is 4913 noise calls a chunk instead of 262144
+    float lattice[CAVE_LATTICE * CAVE_LATTICE * CAVE_LATTICE];
+    for (int lx = 0; lx < CAVE_LATTICE; lx++)
+        for (int ly = 0; ly <= cell_layers; ly++)
+            for (int lz = 0; lz < CAVE_LATTICE; lz++)
+                lattice[(lx * CAVE_LATTICE + ly) * CAVE_LATTICE + lz] = cave_noise.GetNoise(
+                    static_cast<float>(origin.x + lx * CAVE_STEP), static_cast<float>(origin.y + ly * CAVE_STEP), static_cast<float>(origin.z + lz * CAVE_STEP));
+
+    const int size = Chunk::CHUNK_SIZE;
+    const float inv_step = 1.0f / CAVE_STEP;
+    for (int cx = 0; cx < CAVE_LATTICE - 1; cx++)
+    for (int cy = 0; cy < cell_layers; cy++)
+    for (int cz = 0; cz < CAVE_LATTICE - 1; cz++)
+    {
+        float corners[8];
+        for (int corner = 0; corner < 8; corner++)
+            corners[corner] = lattice[((cx + (corner >> 2)) * CAVE_LATTICE + cy + ((corner >> 1) & 1)) * CAVE_LATTICE + cz + (corner & 1)];
+
+        // Trilinear interpolation never goes past the largest corner, so most cells are skipped whole
+        if (*std::max_element(corners, corners + 8) <= settings.cave_threshold) continue;
+
+        for (int x = 0; x < CAVE_STEP; x++)
+        {
+            float fx = x * inv_step;
+            float c00 = corners[0] + (corners[4] - corners[0]) * fx;
+            float c01 = corners[1] + (corners[5] - corners[1]) * fx;
+            float c10 = corners[2] + (corners[6] - corners[2]) * fx;
+            float c11 = corners[3] + (corners[7] - corners[3]) * fx;
+
+            for (int y = 0; y < CAVE_STEP; y++)
+            {
+                float fy = y * inv_step;
+                float c0 = c00 + (c10 - c00) * fy;
+                float c1 = c01 + (c11 - c01) * fy;
+                int vx = cx * CAVE_STEP + x;
+                int vy = cy * CAVE_STEP + y;
+
+                for (int z = 0; z < CAVE_STEP; z++)
+                {
+                    int vz = cz * CAVE_STEP + z;
+                    if (c0 + (c1 - c0) * (z * inv_step) <= settings.cave_threshold) continue;
+                    if (origin.y + vy > column.height[vx * size + vz] - settings.cave_surface_margin) continue;
+
+                    voxels[vx * size * size + vy * size + vz] = VOXEL_AIR;
+                }
+            }
+        }
+    }
+}
+
+void TerrainGenerator::add_stage_timings(const StageTimings& timings)
+{
+    for (int stage = 0; stage < STAGE_COUNT; stage++)
+    {
+        m_stage_runs[stage] += timings[stage].runs;
+        m_stage_nanoseconds[stage] += static_cast<uint64_t>(timings[stage].seconds * 1e9);
+    }
+}
@@ -0,0 +1,167 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include "voxel.h"
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+// Builds chunk voxels in stages:
+//   columns  continental, erosion and detail heightmaps plus a biome per (x, z), cached per chunk column
+//            so the stacked chunks above and below reuse them
+//   strata   surface, filler and stone layers by depth below the surface, per biome
+//   caves    3D noise sampled every CAVE_STEP voxels and trilinearly interpolated, carving air below
+//            the surface
+//   store    packing the dense result into the chunk's palette sections
+// GenerateChunk is safe to call from several workers at once, which is how MultiChunkSystem runs it.
+class TerrainGenerator
+{
+public:
+    enum Biome : uint8_t
+    {
+        BIOME_PLAINS,
+        BIOME_DESERT,
+        BIOME_MOUNTAINS,
+        BIOME_COUNT
+    };
+
+    enum Stage
+    {
+        STAGE_COLUMNS,
+        STAGE_STRATA,
+        STAGE_CAVES,
+        STAGE_STORE,
+        STAGE_COUNT
+    };
+
+    struct Settings
+    {
+        // Heights are in voxels, noise inputs are world voxel coordinates
+        float base_height = 32.0f;
+        float continental_frequency = 0.0015f;
+        float continental_amplitude = 24.0f;
+        float erosion_frequency = 0.004f;
+        // Detail noise amplitude at full erosion and at none
+        float detail_amplitude_eroded = 8.0f;
+        float detail_amplitude_rough = 40.0f;
+        float temperature_frequency = 0.002f;
+
+        // Mountains rise where erosion is below this, by mountain_amplitude per unit under it
+        float mountain_erosion = -0.35f;
+        float mountain_amplitude = 90.0f;
+        float desert_temperature = 0.3f;
+
+        int dirt_depth = 3;
+        int sand_depth = 4;
+        // Up to this many extra dirt or sand voxels per column, drawn from the column's ChunkRandom
+        int surface_depth_jitter = 1;
+        int snow_height = 96;
+
+        bool caves = true;
+        float cave_frequency = 0.025f;
+        // Caves carve where the cave noise is above this
+        float cave_threshold = 0.55f;
+        // Voxels under the surface that caves leave alone, so they don't riddle the ground from above
+        int cave_surface_margin = 6;
+    };
+
+    struct StageStats
+    {
+        size_t runs = 0;
+        double seconds = 0.0;
+    };
+    typedef std::array<StageStats, STAGE_COUNT> StageTimings;
+
+    struct BenchmarkResult
+    {
+        bool valid = false;
+        size_t chunks = 0;
+        double seconds = 0.0;
+        StageTimings stages;
+    };
+
+    struct DeterminismResult
+    {
+        bool valid = false;
+        int seed = 0;
+        size_t chunks = 0;
+        unsigned int threads = 0;
+        uint64_t single_thread_hash = 0;
+        uint64_t multi_thread_hash = 0;
+        size_t mismatched_chunks = 0;
+    };
+
+    static const int CAVE_STEP = 4;
+    static const size_t MAX_CACHED_COLUMNS = 1024;
+    static const int DETERMINISM_SEED = 1337;
+
+    TerrainGenerator();
+
+    void GenerateChunk(Chunk& chunk);
+
+    const Settings& GetSettings() const;
+    // Clears the column cache, chunks already generated keep the old terrain
+    void SetSettings(const Settings& settings);
+
+    static const char* GetBiomeName(Biome biome);
+    static const char* GetStageName(Stage stage);
+    // Totals since startup (or the last reset) over every worker
+    StageTimings GetStageTimings() const;
+    void ResetStageTimings();
+    size_t GetColumnCacheHits() const;
+    size_t GetColumnCacheMisses() const;
+
+    // Generates a block of chunks on the calling thread, away from the loaded world and with a cold
+    //   column cache, and reports the time spent in each stage
+    const BenchmarkResult& RunBenchmark(int columns_per_axis = 4, int layers = 4);
+    const BenchmarkResult& GetLastBenchmark() const;
+
+    // Generates a block of chunks for a fixed seed twice: in order on the calling thread without the column
+    //   cache, then in reverse order through it on a private pool as wide as the shared one, and compares
+    //   their content hashes. Blocks until the check's own jobs are done, the shared pool is left alone.
+    const DeterminismResult& RunDeterminismCheck(int seed = DETERMINISM_SEED);
+    const DeterminismResult& GetLastDeterminismCheck() const;
+
+private:
+    // One chunk column's worth of the columns stage
+    struct Column
+    {
+        int seed;
+        std::array<int, Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE> height;
+        std::array<Biome, Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE> biome;
+        std::array<uint8_t, Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE> extra_depth;
+        int min_height;
+        int max_height;
+    };
+
+    Settings m_settings;
+    // Bumped by SetSettings so columns built from the old settings aren't cached
+    uint32_t m_settings_version = 0;
+
+    mutable std::mutex m_column_mutex;
+    ChunkMap<std::shared_ptr<const Column>> m_columns;
+    // Insertion order, the oldest column goes once the cache is full
+    std::deque<ChunkID> m_column_order;
+
+    std::array<std::atomic<uint64_t>, STAGE_COUNT> m_stage_nanoseconds;
+    std::array<std::atomic<uint64_t>, STAGE_COUNT> m_stage_runs;
+    std::atomic<uint64_t> m_column_hits{ 0 };
+    std::atomic<uint64_t> m_column_misses{ 0 };
+
+    BenchmarkResult m_last_benchmark;
+    DeterminismResult m_last_determinism_check;
+
+    void generate_chunk(Chunk& chunk, int seed, const Settings& settings, uint32_t settings_version, bool use_cache, StageTimings& timings);
+    // The stages after columns
+    void generate_voxels(Chunk& chunk, const Column& column, const Settings& settings, StageTimings& timings) const;
+    std::shared_ptr<const Column> get_column(glm::ivec2 origin, int seed, const Settings& settings, uint32_t settings_version);
+    std::shared_ptr<const Column> build_column(glm::ivec2 origin, int seed, const Settings& settings) const;
+    void fill_strata(const Column& column, int origin_y, const Settings& settings, uint8_t* voxels) const;
+    void carve_caves(const Column& column, glm::ivec3 origin, const Settings& settings, uint8_t* voxels) const;
+    void add_stage_timings(const StageTimings& timings);
+};
+
+#endif
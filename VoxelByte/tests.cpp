@@ -0,0 +1,1625 @@
+#include "globals.h"
+#include "tests.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <unordered_map>
+
+// ----------<[ CHUNK IDS ]>----------
+// Packs every combination of edge, near-zero and extreme indices (the packed range is -2^20..2^20 - 1 per
+//   axis), which has to unpack to the same index with no two of them sharing an id or setting the top bit
+//   ChunkMap uses for empty slots. Then runs a seeded mix of inserts, erases and finds on a ChunkMap and
+//   an std::unordered_map over a small block of chunks, so probe runs are long and backward-shift erases
+//   keep moving entries; every find has to agree, and the full contents are compared every 1000 steps.
+static bool test_chunk_map(std::string& message)
+{
+    const int limit = 1 << 20;
+    const int axis_values[] = { -limit, -limit + 1, -65, -64, -1, 0, 1, 63, 64, limit - 2, limit - 1 };
+
+    size_t bad_ids = 0;
+    std::unordered_map<ChunkID, glm::ivec3> packed;
+    for (int x : axis_values)
+    {
+        for (int y : axis_values)
+        {
+            for (int z : axis_values)
+            {
+                glm::ivec3 chunk_idx(x, y, z);
+                ChunkID chunk_id = PackChunkID(chunk_idx);
+                if (UnpackChunkID(chunk_id) != chunk_idx || chunk_id >> 63 != 0) bad_ids++;
+                if (!packed.emplace(chunk_id, chunk_idx).second) bad_ids++;
+            }
+        }
+    }
+
+    ChunkMap<int> map;
+    std::unordered_map<ChunkID, int> reference;
+    std::mt19937 rng(1337);
+    const int steps = 200000;
+    size_t mismatches = 0;
+
+    auto compare_contents = [&]()
+    {
+        if (map.Size() != reference.size()) mismatches++;
+        for (const auto& entry : reference)
+        {
+            const int* value = map.Find(entry.first);
+            if (value == nullptr || *value != entry.second) mismatches++;
+        }
+
+        size_t iterated = 0;
+        for (const auto& entry : map)
+        {
+            auto found = reference.find(entry.first);
+            if (found == reference.end() || found->second != entry.second) mismatches++;
+            iterated++;
+        }
+        if (iterated != reference.size()) mismatches++;
+    };
+
+    for (int step = 0; step < steps; step++)
+    {
+        // 8x4x8 chunks straddling zero, grown and shrunk by turns so the table rehashes both full and sparse
+        glm::ivec3 chunk_idx(static_cast<int>(rng() % 8) - 4, static_cast<int>(rng() % 4) - 2, static_cast<int>(rng() % 8) - 4);
+        ChunkID chunk_id = PackChunkID(chunk_idx);
+        bool growing = (step / 20000) % 2 == 0;
+
+        switch (rng() % 4)
+        {
+        case 0:
+        case 1:
+            if (growing) { map[chunk_id] = step; reference[chunk_id] = step; }
+            else if (map.Erase(chunk_id) != (reference.erase(chunk_id) > 0)) mismatches++;
+            break;
+        case 2:
+            if (map.Erase(chunk_id) != (reference.erase(chunk_id) > 0)) mismatches++;
+            break;
+        default:
+        {
+            const int* value = map.Find(chunk_id);
+            auto found = reference.find(chunk_id);
+            if ((value == nullptr) != (found == reference.end()) || (value != nullptr && *value != found->second)) mismatches++;
+            break;
+        }
+        }
+
+        if (step % 1000 == 999) compare_contents();
+        if (step == steps / 2) { map.Clear(); reference.clear(); }
+    }
+    compare_contents();
+
+    message = std::to_string(packed.size()) + " ids, " + std::to_string(bad_ids) + " bad, " + std::to_string(steps) +
+              " map steps, " + std::to_string(mismatches) + " mismatches";
+    return bad_ids == 0 && mismatches == 0;
+}
+
+// Loads and unloads chunks on a MultiChunkSystem of its own, so slots keep being reused. Every handle to
+//   a chunk that has since been removed has to stop resolving, even once another chunk sits in its slot,
+//   while handles to loaded chunks keep resolving to their own chunk.
+bool TestRunner::test_chunk_handles(std::string& message)
+{
+    MultiChunkSystem chunks;
+    std::vector<std::pair<ChunkHandle, Chunk*>> loaded, removed;
+    size_t reused_slots = 0, bad_handles = 0;
+
+    auto add = [&](glm::ivec3 chunk_idx)
+    {
+        std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>(PackChunkID(chunk_idx), chunk_idx * Chunk::CHUNK_SIZE);
+        Chunk* added = chunk.get();
+        ChunkHandle handle = chunks.add_chunk(std::move(chunk));
+        for (const auto& stale : removed) if (stale.first.index == handle.index) { reused_slots++; break; }
+        loaded.push_back({ handle, added });
+    };
+
+    for (int round = 0; round < 16; round++)
+    {
+        for (int i = 0; i < 4; i++) add(glm::ivec3(round, i - 2, -i));
+
+        // Remove every other chunk still loaded, oldest first
+        for (size_t i = 0; i < loaded.size(); i++)
+        {
+            if (i % 2 != 0) continue;
+            std::unique_ptr<Chunk> chunk = chunks.remove_chunk(loaded[i].second->GetChunkID());
+            if (chunk.get() != loaded[i].second) bad_handles++;
+            removed.push_back({ loaded[i].first, nullptr });
+        }
+        for (size_t i = 0, kept = 0; i < loaded.size(); i++) if (i % 2 != 0) loaded[kept++] = loaded[i];
+        loaded.resize(loaded.size() / 2);
+
+        for (const auto& stale : removed) if (chunks.ResolveChunkHandle(stale.first) != nullptr) bad_handles++;
+        for (const auto& live : loaded)
+        {
+            if (chunks.ResolveChunkHandle(live.first) != live.second) bad_handles++;
+            if (chunks.GetChunkHandle(live.second->GetChunkID()).generation != live.first.generation) bad_handles++;
+        }
+    }
+    if (chunks.ResolveChunkHandle(ChunkHandle()) != nullptr) bad_handles++;
+
+    message = std::to_string(removed.size()) + " removed, " + std::to_string(reused_slots) + " slots reused, " +
+              std::to_string(bad_handles) + " bad handles";
+    return reused_slots > 0 && bad_handles == 0;
+}
+
+// ----------<[ NOISE ]>----------
+// Largest difference allowed between FillNoise2D and FastNoiseLite, on noise in -1..1
+static const float NOISE_EPSILON = 1e-5f;
+
+// Fills grids whose rows (size.y) aren't a multiple of 8 or 4, at negative and far-out origins, with the
+//   game's noise and another seed and frequency, through each kernel this CPU can run. Every sample has
+//   to be within NOISE_EPSILON of FastNoiseLite::GetNoise at the same position.
+static bool test_noise_batch(std::string& message)
+{
+    std::shared_ptr<NoiseGenerator> generator = VB::inst().GetNoiseGenerator();
+    const int other_seed = 4242;
+    const float other_frequency = 0.037f;
+    FastNoiseLite other_noise(other_seed);
+    other_noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    other_noise.SetFrequency(other_frequency);
+
+    const glm::ivec2 origins[] = { { 0, 0 }, { -37, -1000 }, { 100003, -65 }, { -200000, 150007 } };
+    const int row_lengths[] = { 1, 3, 5, 7, 9, 13, 29, 61, 67 };
+    const int rows = 5;
+
+    std::string kernels;
+    size_t samples = 0, bad_samples = 0;
+    float max_error = 0.0f;
+    std::vector<float> out;
+    for (bool use_avx2 : { true, false })
+    {
+        // Builds without SSE2 only have the scalar path, which the SSE2 pass then runs
+        if (!NoiseGenerator::SetUseAVX2(use_avx2) && use_avx2) continue;
+        kernels += std::string(kernels.empty() ? "" : ", ") + NoiseGenerator::GetSimdName();
+
+        for (const glm::ivec2& origin : origins)
+        {
+            for (int row_length : row_lengths)
+            {
+                glm::ivec2 size(rows, row_length);
+                out.resize(static_cast<size_t>(rows) * row_length);
+                for (bool other : { false, true })
+                {
+                    const FastNoiseLite& noise = other ? other_noise : generator->GetNoise();
+                    if (other) generator->FillNoise2D(other_seed, other_frequency, origin, size, out.data());
+                    else generator->FillNoise2D(origin, size, out.data());
+
+                    for (int x = 0; x < size.x; x++)
+                        for (int y = 0; y < size.y; y++)
+                        {
+                            float expected = noise.GetNoise(static_cast<float>(origin.x + x), static_cast<float>(origin.y + y));
+                            float error = std::fabs(out[x * size.y + y] - expected);
+                            max_error = std::max(max_error, error);
+                            if (!(error <= NOISE_EPSILON)) bad_samples++;
+                            samples++;
+                        }
+                }
+            }
+        }
+    }
+    NoiseGenerator::SetUseAVX2(true);
+
+    char error_text[32];
+    std::snprintf(error_text, sizeof(error_text), "%.2e", max_error);
+    message = std::to_string(samples) + " samples (" + kernels + "), " +
+              std::to_string(bad_samples) + " off by more than the epsilon, max error " + error_text;
+    return bad_samples == 0;
+}
+
+// ----------<[ CHUNK GENERATION ]>----------
+// Combined hash of the block test_generation_determinism() generates. Terrain changes that are meant to
+//   change the output have to update it, the failure message prints the new value.
+static const uint64_t GENERATION_GOLDEN_HASH = 0x3f3044ac633dd23fULL;
+
+// Generates the same block of chunks for DETERMINISM_SEED and the default settings on pools of 1 up to
+//   (at least) 4 workers, with a cold column cache for every run. Each chunk's content hash has to match
+//   the single worker run, and the hashes folded in index order have to match GENERATION_GOLDEN_HASH.
+static bool test_generation_determinism(std::string& message)
+{
+    const glm::ivec3 base_idx(-2048, -2, -2048);
+    const glm::ivec3 block_size(4, 4, 4);
+
+    std::vector<glm::ivec3> chunk_indices;
+    for (int x = 0; x < block_size.x; x++)
+        for (int y = 0; y < block_size.y; y++)
+            for (int z = 0; z < block_size.z; z++)
+                chunk_indices.push_back(base_idx + glm::ivec3(x, y, z));
+
+    std::shared_ptr<NoiseGenerator> noise = VB::inst().GetNoiseGenerator();
+    std::shared_ptr<TerrainGenerator> terrain = VB::inst().GetTerrainGenerator();
+    const int world_seed = noise->GetSeed();
+    const float world_frequency = noise->GetFrequency();
+    const TerrainGenerator::Settings world_settings = terrain->GetSettings();
+    noise->SetSeed(TerrainGenerator::DETERMINISM_SEED);
+    noise->SetFrequency(0.01f);
+
+    unsigned int max_threads = std::max(4u, std::thread::hardware_concurrency());
+    std::vector<uint64_t> expected;
+    size_t mismatched = 0;
+
+    for (unsigned int threads = 1; threads <= max_threads; threads++)
+    {
+        terrain->SetSettings(TerrainGenerator::Settings());
+
+        std::vector<uint64_t> hashes(chunk_indices.size());
+        {
+            ThreadPool pool(threads);
+            for (size_t i = 0; i < chunk_indices.size(); i++)
+            {
+                pool.Submit([&chunk_indices, &hashes, i]()
+                {
+                    Chunk chunk(PackChunkID(chunk_indices[i]), chunk_indices[i] * Chunk::CHUNK_SIZE);
+                    chunk.GenerateChunk();
+                    hashes[i] = chunk.GetContentHash();
+                });
+            }
+            pool.WaitIdle();
+        }
+
+        if (expected.empty()) expected = hashes;
+        for (size_t i = 0; i < hashes.size(); i++)
+            if (hashes[i] != expected[i]) mismatched++;
+    }
+
+    noise->SetSeed(world_seed);
+    noise->SetFrequency(world_frequency);
+    terrain->SetSettings(world_settings);
+
+    uint64_t combined = 0xcbf29ce484222325ULL;
+    for (uint64_t hash : expected) combined = (combined ^ hash) * 0x100000001b3ULL;
+
+    char combined_text[32];
+    std::snprintf(combined_text, sizeof(combined_text), "%016llx", static_cast<unsigned long long>(combined));
+    message = std::to_string(chunk_indices.size()) + " chunks on 1.." + std::to_string(max_threads) + " workers, " +
+              std::to_string(mismatched) + " differ, combined hash " + combined_text;
+    if (combined != GENERATION_GOLDEN_HASH) message += " (golden mismatch)";
+    return mismatched == 0 && combined == GENERATION_GOLDEN_HASH;
+}
+
+// ----------<[ MESHING ]>----------
+// Quad count and quad hash of the reference mesh of each test_mesher_golden() case, in case order. Mesher
+//   changes that are meant to change the output have to update them, as do terrain changes for the
+//   generated cases; the failure message prints the new values.
+struct MesherGolden
+{
+    const char* name;
+    size_t quads;
+    uint64_t hash;
+};
+static const MesherGolden MESHER_GOLDEN[] =
+{
+    { "noise", 358844, 0xebbea043eec69935ULL },
+    { "checkerboard", 786432, 0x5d954521c29c5411ULL },
+    { "single voxels", 18, 0x158180385feb2761ULL },
+    { "solid, open borders", 18, 0xecf04a926e0411f1ULL },
+    { "solid, solid neighbours", 0, 0x4475327f98e05411ULL },
+    { "slabs across mesh sections", 18, 0xc04e7630446d5f61ULL },
+    { "generated y -2", 6554, 0x55000d64e4e5fe43ULL },
+    { "generated y -1", 4612, 0xc5c48f981f2ff59fULL },
+    { "generated y 0", 7683, 0x6d266a89bf85ca6dULL },
+    { "generated y 1", 4597, 0x719afa26ecec5ec7ULL },
+};
+
+// Hash of every section's quads, sorted the way HasSameQuads() compares them so the order they were
+//   emitted in doesn't matter
+static uint64_t mesh_quad_hash(const VoxelRenderer::VoxelMesh& mesh)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int s = 0; s < VoxelRenderer::MESH_SECTIONS; s++)
+    {
+        const VoxelRenderer::VoxelMesh::Section& section = mesh.sections[s];
+        std::vector<std::array<uint32_t, 4>> quads;
+        for (size_t i = 0; i + 5 < section.indices.size(); i += 6)
+        {
+            quads.push_back({ section.vertices[section.indices[i]], section.vertices[section.indices[i + 1]],
+                              section.vertices[section.indices[i + 2]], section.vertices[section.indices[i + 5]] });
+        }
+        std::sort(quads.begin(), quads.end());
+
+        hash = (hash ^ static_cast<uint64_t>(s)) * 0x100000001b3ULL;
+        for (const std::array<uint32_t, 4>& quad : quads)
+            for (uint32_t vertex : quad) hash = (hash ^ vertex) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Meshes hand built and generated chunks with both GenerateChunkMesh() and the greedy reference mesher and
+//   requires the same quads in every mesh section, and the reference meshes to match MESHER_GOLDEN
+static bool test_mesher_golden(std::string& message)
+{
+    std::shared_ptr<VoxelRenderer> renderer = VB::inst().GetVoxel();
+    const int N = Chunk::CHUNK_SIZE;
+
+    struct Case
+    {
+        std::string name;
+        std::unique_ptr<Chunk> chunk;
+        std::vector<std::unique_ptr<Chunk>> neighbour_chunks;
+        ChunkNeighbours neighbours = ChunkNeighbours();
+    };
+    std::vector<Case> cases;
+
+    auto add_case = [&cases](const std::string& name)
+    {
+        cases.push_back(Case());
+        cases.back().name = name;
+        cases.back().chunk = std::make_unique<Chunk>(PackChunkID(glm::ivec3(0)), glm::ivec3(0));
+        return cases.size() - 1;
+    };
+    auto add_neighbours = [&cases](size_t c, const std::function<void(Chunk&, int)>& fill)
+    {
+        for (int face = 0; face < 6; face++)
+        {
+            cases[c].neighbour_chunks.push_back(std::make_unique<Chunk>(PackChunkID(glm::ivec3(0)), glm::ivec3(0)));
+            fill(*cases[c].neighbour_chunks.back(), face);
+            cases[c].neighbours[face] = cases[c].neighbour_chunks.back().get();
+        }
+    };
+
+    // Noise over every registered id and air, so runs break on id changes as well as on air
+    uint32_t state = 12345u;
+    auto noise_fill = [&state, N](Chunk& chunk, int)
+    {
+        for (int x = 0; x < N; x++)
+            for (int y = 0; y < N; y++)
+                for (int z = 0; z < N; z++)
+                {
+                    state = state * 1664525u + 1013904223u;
+                    uint32_t r = state >> 24;
+                    chunk.SetVoxel(glm::ivec3(x, y, z), static_cast<uint8_t>(r < 128 ? 0 : 1 + r % 5));
+                }
+    };
+
+    size_t c = add_case("noise");
+    noise_fill(*cases[c].chunk, 0);
+    add_neighbours(c, noise_fill);
+
+    c = add_case("checkerboard");
+    for (int x = 0; x < N; x++)
+        for (int y = 0; y < N; y++)
+            for (int z = 0; z < N; z++)
+                if ((x + y + z) % 2 == 0) cases[c].chunk->SetVoxel(glm::ivec3(x, y, z), 2);
+
+    c = add_case("single voxels");
+    cases[c].chunk->SetVoxel(glm::ivec3(0, 0, 0), 1);
+    cases[c].chunk->SetVoxel(glm::ivec3(N - 1, N - 1, N - 1), 3);
+    cases[c].chunk->SetVoxel(glm::ivec3(20, 33, 47), 4);
+
+    c = add_case("solid, open borders");
+    cases[c].chunk->Fill(1);
+
+    c = add_case("solid, solid neighbours");
+    cases[c].chunk->Fill(1);
+    add_neighbours(c, [](Chunk& chunk, int) { chunk.Fill(5); });
+
+    c = add_case("slabs across mesh sections");
+    for (int x = 4; x < 60; x++)
+        for (int y = 10; y < 40; y++)
+            for (int z = 0; z < N; z++)
+                cases[c].chunk->SetVoxel(glm::ivec3(x, y, z), y < 25 ? 2 : 3);
+
+    const glm::ivec3 face_steps[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    for (int y = -2; y <= 1; y++)
+    {
+        glm::ivec3 chunk_idx(3072, y, 3072);
+        c = add_case("generated y " + std::to_string(y));
+        cases[c].chunk = std::make_unique<Chunk>(PackChunkID(chunk_idx), chunk_idx * N);
+        cases[c].chunk->GenerateChunk();
+        for (int face = 0; face < 6; face++)
+        {
+            glm::ivec3 neighbour_idx = chunk_idx + face_steps[face];
+            cases[c].neighbour_chunks.push_back(std::make_unique<Chunk>(PackChunkID(neighbour_idx), neighbour_idx * N));
+            cases[c].neighbour_chunks.back()->GenerateChunk();
+            cases[c].neighbours[face] = cases[c].neighbour_chunks.back().get();
+        }
+    }
+
+    std::string failed, golden_failed;
+    size_t quads = 0;
+    const size_t golden_count = sizeof(MESHER_GOLDEN) / sizeof(MESHER_GOLDEN[0]);
+    for (size_t i = 0; i < cases.size(); i++)
+    {
+        const Case& test_case = cases[i];
+        VoxelRenderer::VoxelMesh mesh = renderer->GenerateChunkMesh(*test_case.chunk, test_case.neighbours);
+        VoxelRenderer::VoxelMesh reference = renderer->GenerateChunkMeshReference(*test_case.chunk, test_case.neighbours);
+        if (!mesh.HasSameQuads(reference)) failed += (failed.empty() ? "" : ", ") + test_case.name;
+
+        size_t case_quads = 0;
+        for (int s = 0; s < VoxelRenderer::MESH_SECTIONS; s++) case_quads += reference.sections[s].indices.size() / 6;
+        quads += case_quads;
+
+        uint64_t hash = mesh_quad_hash(reference);
+        if (i < golden_count && test_case.name == MESHER_GOLDEN[i].name && case_quads == MESHER_GOLDEN[i].quads && hash == MESHER_GOLDEN[i].hash) continue;
+
+        char golden_text[160];
+        std::snprintf(golden_text, sizeof(golden_text), "{ \"%s\", %zu, 0x%016llxULL }", test_case.name.c_str(), case_quads,
+                      static_cast<unsigned long long>(hash));
+        golden_failed += (golden_failed.empty() ? "" : ", ") + std::string(golden_text);
+    }
+    if (cases.size() != golden_count) golden_failed += (golden_failed.empty() ? "" : ", ") + std::string("case count changed");
+
+    message = std::to_string(cases.size()) + " chunks, " + std::to_string(quads) + " reference quads";
+    if (!failed.empty()) message += ", differ: " + failed;
+    if (!golden_failed.empty()) message += ", golden mismatch: " + golden_failed;
+    return failed.empty() && golden_failed.empty();
+}
+
+// Merging faces per voxel id can only split quads where the id changes. Meshes a block of generated chunks
+//   once as generated and once with every solid voxel collapsed to one id, and requires the first to need
+//   at most MAX_QUAD_RATIO times as many quads as the second.
+static bool test_mesher_quad_ratio(std::string& message)
+{
+    const double MAX_QUAD_RATIO = 1.2;
+
+    std::shared_ptr<VoxelRenderer> renderer = VB::inst().GetVoxel();
+    const int N = Chunk::CHUNK_SIZE;
+    const glm::ivec3 base_idx(3072, -2, -3072);
+    const int n = 4;
+
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::vector<std::unique_ptr<Chunk>> solid_chunks;
+    std::vector<uint8_t> voxels(static_cast<size_t>(N) * N * N);
+    for (int x = 0; x < n; x++)
+    {
+        for (int y = 0; y < n; y++)
+        {
+            for (int z = 0; z < n; z++)
+            {
+                glm::ivec3 chunk_idx = base_idx + glm::ivec3(x, y, z);
+                chunks.push_back(std::make_unique<Chunk>(PackChunkID(chunk_idx), chunk_idx * N));
+                chunks.back()->GenerateChunk();
+
+                chunks.back()->CopyRegion(glm::ivec3(0), glm::ivec3(N), voxels.data(), static_cast<size_t>(N) * N, N);
+                for (uint8_t& id : voxels) id = id != 0 ? 1 : 0;
+                solid_chunks.push_back(std::make_unique<Chunk>(PackChunkID(chunk_idx), chunk_idx * N));
+                solid_chunks.back()->SetVoxels(voxels.data());
+            }
+        }
+    }
+
+    // Neighbours within the block, so border faces get culled like they are in the world
+    const glm::ivec3 face_steps[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    auto neighbours_of = [&](const std::vector<std::unique_ptr<Chunk>>& block, int i)
+    {
+        ChunkNeighbours neighbours = ChunkNeighbours();
+        glm::ivec3 idx(i / (n * n), i / n % n, i % n);
+        for (int face = 0; face < 6; face++)
+        {
+            glm::ivec3 other = idx + face_steps[face];
+            if (glm::all(glm::greaterThanEqual(other, glm::ivec3(0))) && glm::all(glm::lessThan(other, glm::ivec3(n))))
+                neighbours[face] = block[other.x * n * n + other.y * n + other.z].get();
+        }
+        return neighbours;
+    };
+    auto count_quads = [](const VoxelRenderer::VoxelMesh& mesh)
+    {
+        size_t quads = 0;
+        for (int s = 0; s < VoxelRenderer::MESH_SECTIONS; s++) quads += mesh.sections[s].indices.size() / 6;
+        return quads;
+    };
+
+    size_t quads = 0, solid_quads = 0;
+    for (int i = 0; i < static_cast<int>(chunks.size()); i++)
+    {
+        quads += count_quads(renderer->GenerateChunkMesh(*chunks[i], neighbours_of(chunks, i)));
+        solid_quads += count_quads(renderer->GenerateChunkMesh(*solid_chunks[i], neighbours_of(solid_chunks, i)));
+    }
+
+    double ratio = solid_quads > 0 ? static_cast<double>(quads) / solid_quads : 1.0;
+    char ratio_text[64];
+    std::snprintf(ratio_text, sizeof(ratio_text), "ratio %.3f (max %.2f)", ratio, MAX_QUAD_RATIO);
+    message = std::to_string(chunks.size()) + " chunks, " + std::to_string(quads) + " quads by id, " + std::to_string(solid_quads) +
+              " solid, " + ratio_text;
+    return solid_quads > 0 && ratio <= MAX_QUAD_RATIO;
+}
+
+// Stores each case's chunk and its six neighbours twice: Optimize()d, so uniform sections (and chunks) are
+//   elided, and through SetVoxels with every section kept packed. Both have to mesh to the same quads at
+//   lod 0, 1 and MAX_LOD. The cases put uniform sections against each other, against mixed sections and
+//   against neighbour chunks, with solid / air borders on and off section boundaries.
+static bool test_mesher_elision(std::string& message)
+{
+    std::shared_ptr<VoxelRenderer> renderer = VB::inst().GetVoxel();
+    const int N = Chunk::CHUNK_SIZE;
+    const int S = Chunk::SECTION_SIZE;
+    const int P = Chunk::SECTIONS_PER_AXIS;
+    std::vector<uint8_t> voxels(static_cast<size_t>(N) * N * N);
+
+    // Fills voxels for the chunk at a chunk index
+    typedef std::function<void(const glm::ivec3& chunk_idx)> Fill;
+    auto by_position = [&voxels, N](std::function<uint8_t(const glm::ivec3&)> id_at) -> Fill
+    {
+        return [&voxels, N, id_at](const glm::ivec3& chunk_idx)
+        {
+            for (int x = 0; x < N; x++)
+                for (int y = 0; y < N; y++)
+                    for (int z = 0; z < N; z++)
+                        voxels[(x * N + y) * N + z] = id_at(chunk_idx * N + glm::ivec3(x, y, z));
+        };
+    };
+    auto scatter = [](const glm::ivec3& pos)
+    {
+        return static_cast<uint32_t>(pos.x * 73856093 ^ pos.y * 19349663 ^ pos.z * 83492791) >> 5;
+    };
+    // Inside the chunk at index 0, the one meshed in the hand built cases
+    auto in_chunk = [N](const glm::ivec3& pos)
+    {
+        return glm::all(glm::greaterThanEqual(pos, glm::ivec3(0))) && glm::all(glm::lessThan(pos, glm::ivec3(N)));
+    };
+
+    struct Case
+    {
+        std::string name;
+        glm::ivec3 chunk_idx;
+        Fill fill;
+    };
+    std::vector<Case> cases =
+    {
+        { "air over solid on a section border", glm::ivec3(0), by_position([](const glm::ivec3& p) { return uint8_t(p.y < 32 ? 1 : 0); }) },
+        { "air over solid mid-section", glm::ivec3(0), by_position([](const glm::ivec3& p) { return uint8_t(p.y < 37 ? 2 : 0); }) },
+        { "solid sections of two ids", glm::ivec3(0), by_position([](const glm::ivec3& p) { return uint8_t(((p.x >> 4) + (p.z >> 4)) % 2 ? 1 : 3); }) },
+        { "alternating solid and air sections", glm::ivec3(0), by_position([](const glm::ivec3& p) { return uint8_t(((p.x >> 4) + (p.y >> 4) + (p.z >> 4)) & 1 ? 1 : 0); }) },
+        { "solid chunk, air neighbours", glm::ivec3(0), by_position([&in_chunk](const glm::ivec3& p) { return uint8_t(in_chunk(p) ? 4 : 0); }) },
+        { "solid chunk, mixed neighbours", glm::ivec3(0), by_position([&in_chunk, &scatter](const glm::ivec3& p) { return uint8_t(in_chunk(p) ? 4 : scatter(p) % 3); }) },
+        { "mixed sections among air", glm::ivec3(0), by_position([S, &in_chunk, &scatter](const glm::ivec3& p)
+            { return uint8_t(in_chunk(p) && (p.x / S + p.y / S * 3 + p.z / S * 5) % 4 == 0 ? scatter(p) % 6 : 0); }) },
+    };
+
+    // Generated terrain from the sky down through the surface, copied out of the generated chunk
+    for (int y = -2; y <= 1; y++)
+    {
+        cases.push_back({ "generated y " + std::to_string(y), glm::ivec3(3072, y, -3072), [&voxels, N](const glm::ivec3& chunk_idx)
+        {
+            Chunk chunk(PackChunkID(chunk_idx), chunk_idx * N);
+            chunk.GenerateChunk();
+            chunk.CopyRegion(glm::ivec3(0), glm::ivec3(N), voxels.data(), static_cast<size_t>(N) * N, N);
+        } });
+    }
+
+    // Stores voxels with uniform sections elided, or packed: one voxel per section set to another id first
+    //   keeps SetVoxels from eliding the section, and setting it back doesn't repack it
+    auto store = [&](const glm::ivec3& chunk_idx, bool elided)
+    {
+        std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>(PackChunkID(chunk_idx), chunk_idx * N);
+        if (elided)
+        {
+            chunk->SetVoxels(voxels.data());
+            chunk->Optimize();
+            return chunk;
+        }
+
+        std::vector<uint8_t> marked = voxels;
+        for (int sx = 0; sx < P; sx++)
+            for (int sy = 0; sy < P; sy++)
+                for (int sz = 0; sz < P; sz++)
+                    marked[(sx * S * N + sy * S) * N + sz * S] ^= 1;
+        chunk->SetVoxels(marked.data());
+        for (int sx = 0; sx < P; sx++)
+            for (int sy = 0; sy < P; sy++)
+                for (int sz = 0; sz < P; sz++)
+                    chunk->SetVoxelUnchecked(glm::ivec3(sx, sy, sz) * S, voxels[(sx * S * N + sy * S) * N + sz * S]);
+        return chunk;
+    };
+    auto uniform_sections = [P](const Chunk& chunk)
+    {
+        size_t count = 0;
+        uint8_t id;
+        for (int sx = 0; sx < P; sx++)
+            for (int sy = 0; sy < P; sy++)
+                for (int sz = 0; sz < P; sz++)
+                    if (chunk.IsSectionUniform(glm::ivec3(sx, sy, sz), id)) count++;
+        return count;
+    };
+
+    const glm::ivec3 face_steps[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    const int lods[] = { 0, 1, MultiChunkSystem::MAX_LOD };
+    std::string failed;
+    size_t elided_sections = 0, packed_uniform_sections = 0, sections = 0;
+    for (const Case& test_case : cases)
+    {
+        std::vector<std::unique_ptr<Chunk>> chunks[2];
+        ChunkNeighbours neighbours[2] = { ChunkNeighbours(), ChunkNeighbours() };
+        for (int elided = 0; elided < 2; elided++)
+        {
+            for (int face = 0; face <= 6; face++)
+            {
+                glm::ivec3 chunk_idx = test_case.chunk_idx + (face < 6 ? face_steps[face] : glm::ivec3(0));
+                test_case.fill(chunk_idx);
+                chunks[elided].push_back(store(chunk_idx, elided != 0));
+                if (face < 6) neighbours[elided][face] = chunks[elided].back().get();
+            }
+
+            for (const std::unique_ptr<Chunk>& chunk : chunks[elided])
+                (elided ? elided_sections : packed_uniform_sections) += uniform_sections(*chunk);
+        }
+        sections += chunks[0].size() * P * P * P;
+
+        for (int lod : lods)
+        {
+            VoxelRenderer::VoxelMesh packed = renderer->GenerateChunkMesh(*chunks[0].back(), neighbours[0], lod);
+            VoxelRenderer::VoxelMesh elided = renderer->GenerateChunkMesh(*chunks[1].back(), neighbours[1], lod);
+            if (!elided.HasSameQuads(packed)) failed += (failed.empty() ? "" : ", ") + test_case.name + " lod " + std::to_string(lod);
+        }
+    }
+
+    message = std::to_string(cases.size()) + " chunks x " + std::to_string(sizeof(lods) / sizeof(lods[0])) + " lods, " +
+              std::to_string(elided_sections) + " of " + std::to_string(sections) + " sections elided, " +
+              std::to_string(packed_uniform_sections) + " left uniform by SetVoxels";
+    if (!failed.empty()) message += ", differ: " + failed;
+    return failed.empty() && elided_sections > 0 && packed_uniform_sections == 0;
+}
+
+// ----------<[ MESH ARENAS ]>----------
+// Drives GpuAllocator through freeing next to free ranges on both sides, resizing in place, growing and a
+//   full compaction. Free + used has to stay equal to the capacity throughout.
+static bool test_gpu_allocator(std::string& message)
+{
+    std::string failed;
+    auto check = [&failed](bool passed, const std::string& name)
+    {
+        if (!passed) failed += (failed.empty() ? "" : ", ") + name;
+    };
+    auto consistent = [](const GpuAllocator& allocator)
+    {
+        GpuAllocator::Stats stats = allocator.GetStats();
+        return stats.free + stats.used == stats.capacity;
+    };
+
+    // Freeing the middle of three allocations merges it with the free ranges before and after it
+    {
+        GpuAllocator allocator(40, 4);
+        size_t a = allocator.Allocate(10, 1);
+        size_t b = allocator.Allocate(10, 2);
+        size_t c = allocator.Allocate(10, 3);
+        size_t d = allocator.Allocate(4, 4);
+        check(a == 0 && b == 12 && c == 24 && d == 36 && allocator.GetAllocationSize(b) == 12, "aligned allocate");
+        check(allocator.Allocate(1, 5) == GpuAllocator::INVALID_OFFSET, "allocate when full");
+
+        allocator.Free(a);
+        allocator.Free(c);
+        check(allocator.GetStats().free_ranges == 2, "free apart");
+        allocator.Free(b);
+        GpuAllocator::Stats stats = allocator.GetStats();
+        check(stats.free_ranges == 1 && stats.largest_free == 36 && stats.fragmentation == 0.0f, "free merges both sides");
+        allocator.Free(d);
+        check(allocator.GetStats().largest_free == 40 && consistent(allocator), "free merges into the end");
+    }
+
+    // Resize grows into the free range right after the allocation and shrinks without moving
+    {
+        GpuAllocator allocator(100);
+        size_t a = allocator.Allocate(10, 1);
+        size_t b = allocator.Allocate(10, 2);
+        allocator.Free(b);
+        check(allocator.Resize(a, 30) && allocator.GetAllocationSize(a) == 30, "resize grows");
+        check(allocator.GetStats().free_ranges == 1 && allocator.GetStats().largest_free == 70 && consistent(allocator), "resize grows ranges");
+
+        check(allocator.Resize(a, 5) && allocator.GetAllocationSize(a) == 5, "resize shrinks");
+        check(allocator.GetStats().free_ranges == 1 && allocator.GetStats().largest_free == 95 && consistent(allocator), "resize shrinks ranges");
+
+        size_t c = allocator.Allocate(20, 3);
+        check(c == 5 && !allocator.Resize(a, 6) && allocator.GetAllocationSize(a) == 5 && consistent(allocator), "resize blocked");
+    }
+
+    // Grow appends free space, merged with a free range already at the end
+    {
+        GpuAllocator allocator(20);
+        allocator.Allocate(10, 1);
+        allocator.Allocate(10, 2);
+        check(allocator.Allocate(10, 3) == GpuAllocator::INVALID_OFFSET, "grow full");
+        allocator.Grow(40);
+        check(allocator.Allocate(10, 3) == 20 && consistent(allocator), "grow allocate");
+        allocator.Grow(60);
+        GpuAllocator::Stats stats = allocator.GetStats();
+        check(stats.capacity == 60 && stats.free_ranges == 1 && stats.largest_free == 30 && consistent(allocator), "grow merges");
+        allocator.Grow(50);
+        check(allocator.GetCapacity() == 60, "grow never shrinks");
+    }
+
+    // Every other allocation freed, then compacted one move at a time until nothing is left to move
+    size_t moves = 0;
+    {
+        const int count = 20;
+        GpuAllocator allocator(count * 10);
+        for (int i = 0; i < count; i++) allocator.Allocate(10, i);
+        for (int i = 0; i < count; i += 2) allocator.Free(i * 10);
+
+        float fragmentation = allocator.GetStats().fragmentation;
+        check(fragmentation > 0.5f, "compaction fragmented");
+
+        GpuAllocator::Move move;
+        while (allocator.NextCompactionMove(move) && moves < static_cast<size_t>(count))
+        {
+            check(move.to < move.from && move.owner == move.from / 10, "compaction move");
+            allocator.ApplyMove(move);
+            moves++;
+
+            GpuAllocator::Stats stats = allocator.GetStats();
+            check(consistent(allocator) && stats.allocations == count / 2, "compaction step totals");
+            check(allocator.GetAllocationSize(move.to) == move.size && allocator.GetAllocationSize(move.from) == 0, "compaction step ranges");
+            check(stats.fragmentation < fragmentation, "compaction step defragments");
+            fragmentation = stats.fragmentation;
+        }
+
+        GpuAllocator::Stats stats = allocator.GetStats();
+        check(stats.free_ranges == 1 && stats.largest_free == count / 2 * 10 && stats.fragmentation == 0.0f, "compaction done");
+    }
+
+    message = std::to_string(moves) + " compaction moves";
+    if (!failed.empty()) message += ", failed: " + failed;
+    return failed.empty();
+}
+
+// ----------<[ FRUSTUM CULLING ]>----------
+// A fixed camera 10 voxels up looking down -Z with a 70 degree vertical field of view, 16:9, near 0.1 and
+//   far 500. Hand placed boxes have to land on the expected side of the planes, and the SSE2 and scalar
+//   tests have to agree on those and on a spread of pseudo random boxes around the camera.
+static bool test_frustum(std::string& message)
+{
+    const glm::vec3 eye(0.0f, 10.0f, 0.0f);
+    const glm::mat4 projection = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    const glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const Frustum frustum(projection * view);
+
+    // At 50 voxels ahead the right plane is 50 * tan(35 deg) * 16 / 9 = 62.2 voxels to the side
+    struct Case
+    {
+        const char* name;
+        glm::vec3 min;
+        glm::vec3 max;
+        bool visible;
+    };
+    const Case cases[] = {
+        { "in front", { -2.0f, 8.0f, -52.0f }, { 2.0f, 12.0f, -48.0f }, true },
+        { "behind", { -2.0f, 8.0f, 48.0f }, { 2.0f, 12.0f, 52.0f }, false },
+        { "around the eye", { -1.0f, 9.0f, -1.0f }, { 1.0f, 11.0f, 1.0f }, true },
+        { "straddling right", { 55.0f, 8.0f, -52.0f }, { 70.0f, 12.0f, -48.0f }, true },
+        { "right of right", { 70.0f, 8.0f, -52.0f }, { 80.0f, 12.0f, -48.0f }, false },
+        { "below bottom", { -2.0f, -80.0f, -52.0f }, { 2.0f, -60.0f, -48.0f }, false },
+        { "straddling far", { -2.0f, 8.0f, -510.0f }, { 2.0f, 12.0f, -490.0f }, true },
+        { "beyond far", { -2.0f, 8.0f, -600.0f }, { 2.0f, 12.0f, -550.0f }, false },
+    };
+
+    std::string failed;
+    size_t disagreements = 0;
+    for (const Case& test_case : cases)
+    {
+        AABB box;
+        box.min = test_case.min;
+        box.max = test_case.max;
+        bool visible = frustum.IsBoxVisible(box);
+        if (visible != frustum.IsBoxVisibleScalar(box)) disagreements++;
+        if (visible != test_case.visible) failed += std::string(failed.empty() ? "" : ", ") + test_case.name;
+    }
+
+    // Chunk sized and smaller boxes scattered around the camera, about a quarter of them visible
+    uint32_t state = 987654321u;
+    auto next_float = [&state](float range)
+    {
+        state = state * 1664525u + 1013904223u;
+        return (static_cast<float>(state >> 8) / 16777216.0f * 2.0f - 1.0f) * range;
+    };
+    const int random_boxes = 10000;
+    size_t random_visible = 0;
+    for (int i = 0; i < random_boxes; i++)
+    {
+        AABB box;
+        box.min = eye + glm::vec3(next_float(600.0f), next_float(200.0f), next_float(600.0f));
+        box.max = box.min + glm::vec3(std::abs(next_float(64.0f)), std::abs(next_float(64.0f)), std::abs(next_float(64.0f)));
+        bool visible = frustum.IsBoxVisible(box);
+        if (visible != frustum.IsBoxVisibleScalar(box)) disagreements++;
+        if (visible) random_visible++;
+    }
+
+    message = std::to_string(std::size(cases)) + " placed boxes, " + std::to_string(random_boxes) + " random boxes (" +
+              std::to_string(random_visible) + " visible), " + std::to_string(disagreements) + " SSE2 / scalar disagreements";
+    if (!failed.empty()) message += ", wrong: " + failed;
+    return failed.empty() && disagreements == 0;
+}
+
+// ----------<[ OCCLUSION CULLING ]>----------
+// A 3x4x3 block of small synthetic chunks: two layers of sky over two layers of stone, with a cave sealed
+//   inside the middle chunk of the bottom layer. Walking from the sky has to reach every sky chunk and the
+//   stone surface under it, but nothing below that. Once a shaft is dug from the surface down into the
+//   cave, the cave chunk has to show up as well.
+static bool test_occlusion_culler(std::string& message)
+{
+    const int size = 16;
+    const glm::ivec3 grid(3, 4, 3);
+    const glm::ivec3 cave_idx(1, 0, 1);
+    const glm::ivec3 camera_idx(1, 3, 1);
+
+    bool solid[256];
+    for (int id = 0; id < 256; id++) solid[id] = id != 0;
+
+    auto voxel_index = [size](int x, int y, int z) { return (x * size + y) * size + z; };
+    auto build_world = [&](bool shaft)
+    {
+        std::vector<std::vector<uint8_t>> chunks(grid.x * grid.y * grid.z);
+        for (int x = 0; x < grid.x; x++)
+        {
+            for (int y = 0; y < grid.y; y++)
+            {
+                for (int z = 0; z < grid.z; z++)
+                {
+                    std::vector<uint8_t>& voxels = chunks[(x * grid.y + y) * grid.z + z];
+                    voxels.assign(size * size * size, y < 2 ? 1 : 0);
+                    if (glm::ivec3(x, y, z) == cave_idx)
+                    {
+                        // Clear of the chunk's faces, so no face connects to another
+                        for (int vx = 4; vx < 12; vx++)
+                            for (int vy = 4; vy < 12; vy++)
+                                for (int vz = 4; vz < 12; vz++) voxels[voxel_index(vx, vy, vz)] = 0;
+                    }
+                    if (shaft && x == cave_idx.x && z == cave_idx.z && y < 2)
+                    {
+                        for (int vx = 6; vx < 10; vx++)
+                            for (int vy = y == cave_idx.y ? 8 : 0; vy < size; vy++)
+                                for (int vz = 6; vz < 10; vz++) voxels[voxel_index(vx, vy, vz)] = 0;
+                    }
+                }
+            }
+        }
+
+        std::vector<FaceConnectivity> connectivity;
+        for (const std::vector<uint8_t>& voxels : chunks) connectivity.push_back(ComputeFaceConnectivity(voxels.data(), size, solid));
+        return connectivity;
+    };
+
+    // Wide enough to hold the whole block, so only the occlusion walk hides chunks
+    const Frustum frustum(glm::ortho(-1000.0f, 1000.0f, -1000.0f, 1000.0f, -1000.0f, 1000.0f));
+
+    auto run = [&](const std::vector<FaceConnectivity>& connectivity, OcclusionCuller& culler)
+    {
+        culler.Run(camera_idx, -1, frustum, [&](const glm::ivec3& chunk_idx, OcclusionCuller::Node& node)
+        {
+            if (glm::any(glm::lessThan(chunk_idx, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(chunk_idx, grid))) return false;
+            node.id = PackChunkID(chunk_idx);
+            node.connectivity = connectivity[(chunk_idx.x * grid.y + chunk_idx.y) * grid.z + chunk_idx.z];
+            node.bounds.min = glm::vec3(chunk_idx * size);
+            node.bounds.max = node.bounds.min + glm::vec3(static_cast<float>(size));
+            return true;
+        });
+    };
+
+    std::string failed;
+    auto check = [&failed](bool passed, const std::string& name)
+    {
+        if (!passed) failed += (failed.empty() ? "" : ", ") + name;
+    };
+
+    // Sky and the stone surface below it, 3 of the 4 layers
+    const size_t surface_count = static_cast<size_t>(grid.x * 3 * grid.z);
+
+    OcclusionCuller sealed;
+    run(build_world(false), sealed);
+    check(sealed.GetVisibleCount() == surface_count, "sealed count");
+    check(sealed.IsVisible(PackChunkID(glm::ivec3(0, 3, 0))) && sealed.IsVisible(PackChunkID(glm::ivec3(2, 2, 2))), "sky kept");
+    check(sealed.IsVisible(PackChunkID(glm::ivec3(1, 1, 1))), "surface kept");
+    bool underground_hidden = true;
+    for (int x = 0; x < grid.x; x++)
+        for (int z = 0; z < grid.z; z++)
+            if (sealed.IsVisible(PackChunkID(glm::ivec3(x, 0, z)))) underground_hidden = false;
+    check(underground_hidden, "sealed cave dropped");
+
+    OcclusionCuller opened;
+    run(build_world(true), opened);
+    check(opened.GetVisibleCount() == surface_count + 1 && opened.IsVisible(PackChunkID(cave_idx)), "opened cave kept");
+
+    message = std::to_string(sealed.GetVisibleCount()) + " of " + std::to_string(grid.x * grid.y * grid.z) + " chunks visible, " +
+              std::to_string(opened.GetVisibleCount()) + " with the cave opened";
+    if (!failed.empty()) message += ", failed: " + failed;
+    return failed.empty();
+}
+
+// ----------<[ WORLD ACCESS ]>----------
+// Loads patterned chunks on both sides of zero on every axis into the game's MultiChunkSystem, leaving one
+//   out, and reads a box across all their borders (and a little way into unloaded chunks past x = -64)
+//   with ReadRegion and a RegionIterator. Both have to match
+//   World::GetVoxel voxel for voxel, unloaded_id included. Then clears two chunks, places a single voxel
+//   and casts rays at it along z across a chunk border and down y, plus two that must miss. The chunks are
+//   removed again before it returns.
+bool TestRunner::test_world_access(std::string& message)
+{
+    std::shared_ptr<MultiChunkSystem> chunks = VB::inst().GetMultiChunkSystem();
+    std::shared_ptr<World> world = VB::inst().GetWorld();
+    const glm::ivec3 unloaded_idx(-1, 0, 0);
+    const uint8_t unloaded_id = 9;
+
+    std::vector<ChunkID> added;
+    std::vector<uint8_t> voxels(Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE);
+    for (int cx = -1; cx <= 0; cx++)
+    for (int cy = -1; cy <= 0; cy++)
+    for (int cz = -1; cz <= 0; cz++)
+    {
+        glm::ivec3 chunk_idx(cx, cy, cz);
+        if (chunk_idx == unloaded_idx || chunks->HasChunk(PackChunkID(chunk_idx))) continue;
+
+        // Ids from the world position, so a voxel read from the wrong chunk or offset shows up
+        glm::ivec3 origin = chunk_idx * Chunk::CHUNK_SIZE;
+        for (int x = 0; x < Chunk::CHUNK_SIZE; x++)
+            for (int y = 0; y < Chunk::CHUNK_SIZE; y++)
+                for (int z = 0; z < Chunk::CHUNK_SIZE; z++)
+                {
+                    glm::ivec3 pos = origin + glm::ivec3(x, y, z);
+                    uint32_t hash = static_cast<uint32_t>(pos.x * 73856093 ^ pos.y * 19349663 ^ pos.z * 83492791);
+                    voxels[(x * Chunk::CHUNK_SIZE + y) * Chunk::CHUNK_SIZE + z] = static_cast<uint8_t>((hash >> 7) % 8);
+                }
+
+        std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>(PackChunkID(chunk_idx), origin);
+        chunk->SetVoxels(voxels.data());
+        chunks->add_chunk(std::move(chunk));
+        added.push_back(PackChunkID(chunk_idx));
+    }
+
+    const glm::ivec3 min(-70, -20, -40), max(30, 25, 50);
+    const glm::ivec3 size = max - min;
+    std::vector<uint8_t> region(static_cast<size_t>(size.x) * size.y * size.z);
+    world->ReadRegion(min, max, region.data(), unloaded_id);
+
+    size_t region_mismatches = 0, iterator_mismatches = 0, unloaded_voxels = 0;
+    World::RegionIterator it = world->IterateRegion(min, max);
+    for (int x = min.x; x < max.x; x++)
+        for (int y = min.y; y < max.y; y++)
+            for (int z = min.z; z < max.z; z++)
+            {
+                glm::ivec3 pos(x, y, z);
+                uint8_t expected = world->GetVoxel(pos, unloaded_id);
+                glm::ivec3 chunk_idx = World::WorldToChunkIdx(pos);
+                bool loaded = chunk_idx != unloaded_idx && glm::all(glm::greaterThanEqual(chunk_idx, glm::ivec3(-1))) &&
+                              glm::all(glm::lessThanEqual(chunk_idx, glm::ivec3(0)));
+                if (!loaded) unloaded_voxels++;
+                if ((expected == unloaded_id) == loaded) region_mismatches++;
+
+                size_t index = (static_cast<size_t>(x - min.x) * size.y + (y - min.y)) * size.z + (z - min.z);
+                if (region[index] != expected) region_mismatches++;
+
+                if (!it.IsValid() || it.GetPosition() != pos || it.GetVoxel(unloaded_id) != expected || (it.GetChunk() != nullptr) != loaded)
+                    iterator_mismatches++;
+                if (it.IsValid()) it.Next();
+            }
+    if (it.IsValid()) iterator_mismatches++;
+
+    // A lone voxel in otherwise empty chunks on both sides of z = 0
+    size_t bad_rays = 0;
+    chunks->GetChunk(PackChunkID(glm::ivec3(0, 0, 0)))->Fill(0);
+    chunks->GetChunk(PackChunkID(glm::ivec3(0, 0, -1)))->Fill(0);
+    const glm::ivec3 target(20, 30, 40);
+    world->SetVoxel(target, 5);
+
+    struct Ray { glm::vec3 origin; glm::vec3 direction; float max_distance; bool hits; glm::ivec3 normal; float distance; };
+    const Ray rays[] =
+    {
+        { glm::vec3(20.5f, 30.5f, -30.5f), glm::vec3(0.0f, 0.0f, 1.0f), 100.0f, true, glm::ivec3(0, 0, -1), 70.5f },
+        { glm::vec3(20.25f, 60.5f, 40.75f), glm::vec3(0.0f, -2.0f, 0.0f), 100.0f, true, glm::ivec3(0, 1, 0), 29.5f },
+        // Stops short of the voxel
+        { glm::vec3(20.5f, 30.5f, -30.5f), glm::vec3(0.0f, 0.0f, 1.0f), 70.0f, false, glm::ivec3(0), 0.0f },
+        // Passes beside it and on into an unloaded chunk, which counts as air
+        { glm::vec3(0.5f, 30.5f, 41.5f), glm::vec3(1.0f, 0.0f, 0.0f), 100.0f, false, glm::ivec3(0), 0.0f },
+    };
+    for (const Ray& ray : rays)
+    {
+        World::RaycastHit hit;
+        bool hits = world->Raycast(ray.origin, ray.direction, ray.max_distance, hit);
+        if (hits != ray.hits) bad_rays++;
+        else if (hits && (hit.position != target || hit.normal != ray.normal || hit.id != 5 || std::abs(hit.distance - ray.distance) > 1e-3f))
+            bad_rays++;
+    }
+
+    for (ChunkID chunk_id : added) chunks->remove_chunk(chunk_id);
+
+    message = std::to_string(region.size()) + " voxels over " + std::to_string(added.size()) + " chunks (" +
+              std::to_string(unloaded_voxels) + " unloaded), " + std::to_string(region_mismatches) + " ReadRegion mismatches, " +
+              std::to_string(iterator_mismatches) + " iterator mismatches, " + std::to_string(bad_rays) + " bad rays";
+    return added.size() == 7 && unloaded_voxels > 0 && region_mismatches == 0 && iterator_mismatches == 0 && bad_rays == 0;
+}
+
+// ----------<[ REGION FILES ]>----------
+// Bytes that depend on the slot and the round, so a slot reading another slot's or an older payload shows up
+static std::vector<uint8_t> test_payload(int slot, int round, size_t size)
+{
+    std::vector<uint8_t> payload(size);
+    for (size_t i = 0; i < size; i++) payload[i] = static_cast<uint8_t>(slot * 31 + round * 7 + i * 13 + (i >> 8));
+    return payload;
+}
+
+// Writes slots of a scratch region file, rewrites some larger and some smaller in one batch, and checks
+//   every slot reads back its latest payload before and after reopening the file. Rewriting every slot a
+//   few more times has to reuse the space earlier payloads left behind rather than growing the file.
+//   Then saves and loads generated chunks through RegionStore and runs its benchmark in the same directory.
+static bool test_region_round_trip(std::string& message)
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "voxelbyte_test_regions";
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+
+    const int slots = 64;
+    std::vector<std::vector<uint8_t>> expected(slots);
+    size_t bad_slots = 0;
+    bool file_grew = false;
+
+    auto check_slots = [&](RegionFile& region)
+    {
+        for (int slot = 0; slot < slots; slot++)
+        {
+            bool same = region.Read(slot, [&](const uint8_t* data, size_t size)
+            {
+                return size == expected[slot].size() && std::equal(data, data + size, expected[slot].begin());
+            });
+            if (!same) bad_slots++;
+        }
+        for (int slot = slots; slot < RegionFile::SLOT_COUNT; slot++)
+            if (region.Has(slot)) bad_slots++;
+    };
+
+    {
+        RegionFile region(directory / "r.test.vbr");
+        for (int slot = 0; slot < slots; slot++)
+        {
+            expected[slot] = test_payload(slot, 0, 100 + slot * 37);
+            if (!region.Write(slot, expected[slot].data(), expected[slot].size())) bad_slots++;
+        }
+        check_slots(region);
+
+        // Every third slot grows past its capacity, every other one shrinks, the rest are left alone
+        std::vector<RegionFile::SlotWrite> writes;
+        for (int slot = 0; slot < slots; slot++)
+        {
+            if (slot % 3 == 0) expected[slot] = test_payload(slot, 1, expected[slot].size() + 700);
+            else if (slot % 2 == 0) expected[slot] = test_payload(slot, 1, expected[slot].size() / 2 + 1);
+            else continue;
+            writes.push_back({ slot, expected[slot].data(), expected[slot].size() });
+        }
+        if (!region.Write(writes)) bad_slots++;
+        check_slots(region);
+
+        size_t live_bytes = 0;
+        for (int round = 2; round < 8; round++)
+        {
+            writes.clear();
+            live_bytes = 0;
+            for (int slot = 0; slot < slots; slot++)
+            {
+                expected[slot] = test_payload(slot, round, expected[slot].size());
+                writes.push_back({ slot, expected[slot].data(), expected[slot].size() });
+                live_bytes += expected[slot].size();
+            }
+            if (!region.Write(writes)) bad_slots++;
+        }
+        check_slots(region);
+        if (region.GetFileSize() > 3 * live_bytes) file_grew = true;
+    }
+    {
+        RegionFile reopened(directory / "r.test.vbr");
+        check_slots(reopened);
+    }
+
+    // Chunks across two regions and two layers, saved and loaded through the store
+    std::shared_ptr<RegionStore> store = VB::inst().GetRegionStore();
+    const std::filesystem::path save_directory = store->GetWorldDirectory().parent_path();
+    store->SetSaveDirectory(directory);
+
+    std::vector<glm::ivec3> chunk_indices = { { 30, -1, 5 }, { 31, -1, 5 }, { 32, -1, 5 }, { 32, 0, 5 }, { -1, -1, -1 } };
+    std::vector<uint64_t> hashes;
+    for (const glm::ivec3& chunk_idx : chunk_indices)
+    {
+        Chunk chunk(PackChunkID(chunk_idx), chunk_idx * Chunk::CHUNK_SIZE);
+        chunk.GenerateChunk();
+        chunk.SetVoxel(glm::ivec3(1, 2, 3), 5);
+        hashes.push_back(chunk.GetContentHash());
+        store->SaveChunk(chunk);
+    }
+    store->CloseAll();
+
+    size_t bad_chunks = 0;
+    for (size_t i = 0; i < chunk_indices.size(); i++)
+    {
+        Chunk chunk(PackChunkID(chunk_indices[i]), chunk_indices[i] * Chunk::CHUNK_SIZE);
+        if (!store->LoadChunk(chunk) || chunk.GetContentHash() != hashes[i]) bad_chunks++;
+    }
+
+    glm::ivec3 unsaved_idx(33, -1, 5);
+    Chunk unsaved(PackChunkID(unsaved_idx), unsaved_idx * Chunk::CHUNK_SIZE);
+    if (store->LoadChunk(unsaved)) bad_chunks++;
+
+    const RegionStore::BenchmarkResult& benchmark = store->RunBenchmark(2);
+    bad_chunks += benchmark.mismatched_chunks;
+
+    store->SetSaveDirectory(save_directory);
+    std::filesystem::remove_all(directory, error);
+
+    message = std::to_string(slots) + " slots, " + std::to_string(bad_slots) + " bad reads, " +
+              std::to_string(chunk_indices.size()) + " chunks + benchmark, " + std::to_string(bad_chunks) + " bad loads";
+    if (file_grew) message += ", file kept growing";
+    return bad_slots == 0 && !file_grew && bad_chunks == 0;
+}
+
+// ----------<[ CHUNK CODEC ]>----------
+// Encodes generated, uniform, noise and long run chunks with and without LZ and through every Serialize
+//   format, and requires the same content back. Truncated, padded and corrupted encodings have to be
+//   rejected without touching the chunk, or decode to some chunk without reading out of bounds.
+static bool test_codec_round_trip(std::string& message)
+{
+    const int N = Chunk::CHUNK_SIZE;
+    std::vector<std::pair<std::string, std::unique_ptr<Chunk>>> chunks;
+    auto add_chunk = [&chunks](const std::string& name, const glm::ivec3& chunk_idx)
+    {
+        chunks.push_back({ name, std::make_unique<Chunk>(PackChunkID(chunk_idx), chunk_idx * Chunk::CHUNK_SIZE) });
+        return chunks.back().second.get();
+    };
+
+    for (int y = -2; y <= 1; y++) add_chunk("generated y " + std::to_string(y), glm::ivec3(-3072, y, 3072))->GenerateChunk();
+    add_chunk("air", glm::ivec3(0));
+    add_chunk("stone", glm::ivec3(0))->Fill(2);
+
+    // Every id, in runs of 1 to 4, so the runs barely compress
+    Chunk* noise = add_chunk("noise", glm::ivec3(0));
+    uint32_t state = 54321u;
+    for (int x = 0; x < N; x++)
+        for (int y = 0; y < N; y++)
+            for (int z = 0; z < N; z++)
+            {
+                if (z % 4 == 0) state = state * 1664525u + 1013904223u;
+                noise->SetVoxel(glm::ivec3(x, y, z), static_cast<uint8_t>(state >> (8 + z % 4)));
+            }
+
+    // Runs across rows and layers, longer than one and two varint bytes cover, plus a lone voxel at the end
+    Chunk* long_runs = add_chunk("long runs", glm::ivec3(0));
+    for (int x = 0; x < N; x++)
+        for (int y = 0; y < N; y++)
+            for (int z = 0; z < N; z++)
+                long_runs->SetVoxel(glm::ivec3(x, y, z), x < 5 ? 3 : x < 40 ? 4 : 0);
+    long_runs->SetVoxel(glm::ivec3(N - 1, N - 1, N - 1), 255);
+
+    size_t bad_round_trips = 0, bad_rejections = 0, encodings = 0;
+    auto bad_rejection = [&bad_rejections](const std::string& name, bool lz, const std::string& damage)
+    {
+        bad_rejections++;
+        VB::inst().GetLogger()->PrintErr("  codec accepted or half applied " + damage + ": " + name + (lz ? " (lz)" : ""));
+    };
+    std::vector<uint8_t> encoded, damaged;
+    for (const auto& named : chunks)
+    {
+        const Chunk& chunk = *named.second;
+        uint64_t hash = chunk.GetContentHash();
+
+        for (bool lz : { false, true })
+        {
+            encoded.clear();
+            ChunkCodec::Encode(chunk, encoded, lz);
+            encodings++;
+
+            Chunk decoded(chunk.GetChunkID(), glm::ivec3(0));
+            decoded.Fill(7);
+            uint64_t untouched = decoded.GetContentHash();
+            if (!ChunkCodec::Decode(encoded.data(), encoded.size(), lz, decoded) || decoded.GetContentHash() != hash)
+            {
+                bad_round_trips++;
+                VB::inst().GetLogger()->PrintErr("  codec round trip failed: " + named.first + (lz ? " (lz)" : ""));
+            }
+
+            // Cut short anywhere, or with bytes left over, it isn't exactly one chunk
+            for (size_t cut : { size_t(0), size_t(1), encoded.size() / 2, encoded.size() - 1 })
+            {
+                if (cut >= encoded.size()) continue;
+                decoded.Fill(7);
+                if (ChunkCodec::Decode(encoded.data(), cut, lz, decoded) || decoded.GetContentHash() != untouched)
+                    bad_rejection(named.first, lz, "cut to " + std::to_string(cut) + " of " + std::to_string(encoded.size()) + " bytes");
+            }
+            damaged = encoded;
+            damaged.push_back(0);
+            decoded.Fill(7);
+            if (ChunkCodec::Decode(damaged.data(), damaged.size(), lz, decoded) || decoded.GetContentHash() != untouched)
+                bad_rejection(named.first, lz, "trailing byte");
+
+            // Flipped bytes may still decode to some chunk, but a rejection must leave the chunk alone
+            for (size_t i = 0; i < 64; i++)
+            {
+                damaged = encoded;
+                state = state * 1664525u + 1013904223u;
+                damaged[state % damaged.size()] ^= static_cast<uint8_t>(1 + (state >> 24) % 255);
+                decoded.Fill(7);
+                if (!ChunkCodec::Decode(damaged.data(), damaged.size(), lz, decoded) && decoded.GetContentHash() != untouched)
+                    bad_rejection(named.first, lz, "flipped byte");
+            }
+        }
+
+        for (uint8_t format : { Chunk::CHUNK_FORMAT_SECTIONS, Chunk::CHUNK_FORMAT_RUNS, Chunk::CHUNK_FORMAT_RUNS_LZ })
+        {
+            encoded.clear();
+            chunk.Serialize(encoded, format);
+            Chunk deserialized(chunk.GetChunkID(), glm::ivec3(0));
+            if (!deserialized.Deserialize(encoded.data(), encoded.size()) || deserialized.GetContentHash() != hash)
+            {
+                bad_round_trips++;
+                VB::inst().GetLogger()->PrintErr("  serialize round trip failed: " + named.first + ", format " + std::to_string(format));
+            }
+        }
+    }
+
+    const ChunkCodec::BenchmarkResult& benchmark = VB::inst().GetChunkCodec()->RunBenchmark(2, 1);
+    bad_round_trips += benchmark.mismatched_chunks;
+
+    message = std::to_string(chunks.size()) + " chunks, " + std::to_string(encodings) + " encodings + benchmark, " +
+              std::to_string(bad_round_trips) + " bad round trips, " + std::to_string(bad_rejections) + " bad rejections";
+    return bad_round_trips == 0 && bad_rejections == 0;
+}
+
+// ----------<[ BENCHMARKS ]>----------
+// Each logs what the debug menu shows for the same benchmark
+static void bench_noise()
+{
+    const NoiseGenerator::BenchmarkResult& result = VB::inst().GetNoiseGenerator()->RunBenchmark();
+
+    char text[128];
+    std::snprintf(text, sizeof(text), "%zu samples, scalar %.1f M/s, %s %.1f M/s (%.1fx), max error %.2g", result.samples,
+                  result.scalar_samples_per_sec / 1e6, result.simd, result.batch_samples_per_sec / 1e6,
+                  result.scalar_samples_per_sec > 0.0 ? result.batch_samples_per_sec / result.scalar_samples_per_sec : 0.0, result.max_error);
+    VB::inst().GetLogger()->Print(text);
+}
+
+static void bench_terrain()
+{
+    std::shared_ptr<TerrainGenerator> terrain = VB::inst().GetTerrainGenerator();
+    const TerrainGenerator::BenchmarkResult& result = terrain->RunBenchmark();
+
+    std::shared_ptr<Logger> logger = VB::inst().GetLogger();
+    logger->Print(std::to_string(result.chunks) + " chunks, " + std::to_string(result.seconds * 1000.0 / std::max<size_t>(result.chunks, 1)) + " ms each");
+    for (int stage = 0; stage < TerrainGenerator::STAGE_COUNT; stage++)
+    {
+        const TerrainGenerator::StageStats& stats = result.stages[stage];
+        logger->Print(std::string(TerrainGenerator::GetStageName(static_cast<TerrainGenerator::Stage>(stage))) + ": " +
+                      std::to_string(stats.runs) + " runs, " + std::to_string(stats.seconds * 1000.0) + " ms total, " +
+                      std::to_string(stats.runs > 0 ? stats.seconds * 1000.0 / stats.runs : 0.0) + " ms each");
+    }
+}
+
+// Saves to and loads from a scratch directory, the game's saves are left alone
+static void bench_region()
+{
+    const RegionStore::BenchmarkResult& result = VB::inst().GetRegionStore()->RunBenchmark();
+
+    char text[192];
+    std::snprintf(text, sizeof(text), "%zu chunks, %.1f KiB on disk, generate %.1f ms, save %.1f ms, load %.1f ms (%.1fx generate), round trip %s",
+                  result.chunks, result.payload_bytes / 1024.0, result.generate_seconds * 1000.0, result.save_seconds * 1000.0,
+                  result.load_seconds * 1000.0, result.load_seconds > 0.0 ? result.generate_seconds / result.load_seconds : 0.0,
+                  result.mismatched_chunks == 0 ? "OK" : "MISMATCH");
+    VB::inst().GetLogger()->Print(text);
+}
+
+static void bench_codec()
+{
+    const ChunkCodec::BenchmarkResult& result = VB::inst().GetChunkCodec()->RunBenchmark();
+    double raw_bytes = static_cast<double>(result.raw_bytes) * result.repeats;
+    auto ratio = [&](size_t bytes) { return bytes > 0 ? static_cast<double>(result.raw_bytes) / bytes : 0.0; };
+    auto gb_per_sec = [&](double seconds) { return seconds > 0.0 ? raw_bytes / seconds * 1e-9 : 0.0; };
+
+    char text[192];
+    std::shared_ptr<Logger> logger = VB::inst().GetLogger();
+    std::snprintf(text, sizeof(text), "%zu chunks x %d, run detection %s, sections %.1f KiB (%.0fx)", result.chunks, result.repeats,
+                  ChunkCodec::GetSimdName(), result.section_bytes / 1024.0, ratio(result.section_bytes));
+    logger->Print(text);
+    std::snprintf(text, sizeof(text), "runs: %.1f KiB (%.0fx), encode %.2f GB/s, decode %.2f GB/s", result.run_bytes / 1024.0,
+                  ratio(result.run_bytes), gb_per_sec(result.run_encode_seconds), gb_per_sec(result.run_decode_seconds));
+    logger->Print(text);
+    std::snprintf(text, sizeof(text), "runs + lz: %.1f KiB (%.0fx), encode %.2f GB/s, decode %.2f GB/s, round trip %s", result.lz_bytes / 1024.0,
+                  ratio(result.lz_bytes), gb_per_sec(result.lz_encode_seconds), gb_per_sec(result.lz_decode_seconds),
+                  result.mismatched_chunks == 0 ? "OK" : "MISMATCH");
+    logger->Print(text);
+}
+
+// A 33x8x33 chunk world, the size streamed at a generation radius of 16 with 8 layers: three layers of sky
+//   over a surface layer (solid lower half, open upper half) and four underground layers of stone, a quarter
+//   of it crossed by tunnels along x and a quarter by tunnels along z. The occlusion walk is run from the
+//   surface, from high above and from inside a tunnel, and the visible counts and walk times are logged.
+static void bench_occlusion()
+{
+    const int radius = 16;
+    const glm::ivec3 grid(radius * 2 + 1, 8, radius * 2 + 1);
+    const int surface_layer = 4;
+    const int size = Chunk::CHUNK_SIZE;
+
+    bool solid[256];
+    for (int id = 0; id < 256; id++) solid[id] = id != 0;
+
+    enum Template { TEMPLATE_SKY, TEMPLATE_SURFACE, TEMPLATE_STONE, TEMPLATE_TUNNEL_X, TEMPLATE_TUNNEL_Z, TEMPLATE_COUNT };
+    FaceConnectivity template_connectivity[TEMPLATE_COUNT];
+    std::vector<uint8_t> voxels(static_cast<size_t>(size) * size * size);
+    for (int t = 0; t < TEMPLATE_COUNT; t++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            for (int y = 0; y < size; y++)
+            {
+                for (int z = 0; z < size; z++)
+                {
+                    bool open = t == TEMPLATE_SKY || (t == TEMPLATE_SURFACE && y >= size / 2) ||
+                                (t == TEMPLATE_TUNNEL_X && std::abs(y - size / 2) < 4 && std::abs(z - size / 2) < 4) ||
+                                (t == TEMPLATE_TUNNEL_Z && std::abs(y - size / 2) < 4 && std::abs(x - size / 2) < 4);
+                    voxels[(x * size + y) * size + z] = open ? 0 : 1;
+                }
+            }
+        }
+        template_connectivity[t] = ComputeFaceConnectivity(voxels.data(), size, solid);
+    }
+
+    // Tunnels along x every fourth row of chunks, along z every fourth column, x winning where they cross
+    const glm::ivec3 tunnel_camera_idx(radius, 2, radius);
+    std::vector<FaceConnectivity> connectivity(grid.x * grid.y * grid.z);
+    for (int x = 0; x < grid.x; x++)
+    {
+        for (int y = 0; y < grid.y; y++)
+        {
+            for (int z = 0; z < grid.z; z++)
+            {
+                Template t = y > surface_layer ? TEMPLATE_SKY : y == surface_layer ? TEMPLATE_SURFACE : TEMPLATE_STONE;
+                if (t == TEMPLATE_STONE && z % 4 == 0) t = TEMPLATE_TUNNEL_X;
+                else if (t == TEMPLATE_STONE && x % 4 == 2) t = TEMPLATE_TUNNEL_Z;
+                connectivity[(x * grid.y + y) * grid.z + z] = template_connectivity[t];
+            }
+        }
+    }
+
+    auto lookup = [&](const glm::ivec3& chunk_idx, OcclusionCuller::Node& node)
+    {
+        if (glm::any(glm::lessThan(chunk_idx, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(chunk_idx, grid))) return false;
+        node.id = PackChunkID(chunk_idx);
+        node.connectivity = connectivity[(chunk_idx.x * grid.y + chunk_idx.y) * grid.z + chunk_idx.z];
+        node.bounds.min = glm::vec3(chunk_idx * size);
+        node.bounds.max = node.bounds.min + glm::vec3(static_cast<float>(size));
+        return true;
+    };
+
+    struct Camera
+    {
+        const char* name;
+        glm::ivec3 chunk_idx;
+        glm::vec3 direction;
+    };
+    const Camera cameras[] = {
+        { "surface", glm::ivec3(radius, surface_layer + 1, radius), glm::vec3(1.0f, -0.1f, 0.0f) },
+        { "high above", glm::ivec3(radius, grid.y - 1, radius), glm::vec3(1.0f, -1.0f, 0.3f) },
+        { "tunnel", tunnel_camera_idx, glm::vec3(1.0f, 0.0f, 0.0f) },
+    };
+
+    std::shared_ptr<Logger> logger = VB::inst().GetLogger();
+    logger->Print(std::to_string(grid.x) + "x" + std::to_string(grid.y) + "x" + std::to_string(grid.z) + " chunks (" +
+                  std::to_string(connectivity.size()) + ")");
+
+    const int repeats = 20;
+    const glm::mat4 projection = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, static_cast<float>(radius * size) * 1.5f);
+    for (const Camera& camera : cameras)
+    {
+        glm::vec3 eye = glm::vec3(camera.chunk_idx * size) + glm::vec3(size / 2.0f);
+        Frustum frustum(projection * glm::lookAt(eye, eye + glm::normalize(camera.direction), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+        size_t in_frustum = 0;
+        for (int x = 0; x < grid.x; x++)
+        {
+            for (int y = 0; y < grid.y; y++)
+            {
+                for (int z = 0; z < grid.z; z++)
+                {
+                    OcclusionCuller::Node node;
+                    lookup(glm::ivec3(x, y, z), node);
+                    if (frustum.IsBoxVisible(node.bounds)) in_frustum++;
+                }
+            }
+        }
+
+        OcclusionCuller culler;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++) culler.Run(camera.chunk_idx, -1, frustum, lookup);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+
+        logger->Print(std::string(camera.name) + ": " + std::to_string(culler.GetVisibleCount()) + " visible of " +
+                      std::to_string(in_frustum) + " in the frustum, " + std::to_string(ms) + " ms per walk");
+    }
+}
+
+// Generates terrain out to MAX_RADIUS chunks around one column and meshes the surface layers at the LOD
+//   lod_for_chunk() picks for each chunk (with the game's LOD radius), and again all at lod 0. Logs the
+//   quads within each radius, doubling from 4, and how many each doubling added: with rings that double in
+//   width and each LOD cutting a ring's quads by about 4, that stays roughly constant out to the LOD radius
+//   times 2^MAX_LOD, past which quads grow with the area again. Works through the disk one x slab at a
+//   time, so only three slabs of chunks are held at once.
+void TestRunner::bench_lod_rings()
+{
+    const int MAX_RADIUS = 32;
+    const int min_layer = -2, max_layer = 1;
+    const glm::ivec3 center_idx(3072, 0, -3072);
+
+    std::shared_ptr<MultiChunkSystem> chunk_system = VB::inst().GetMultiChunkSystem();
+    std::shared_ptr<VoxelRenderer> renderer = VB::inst().GetVoxel();
+    std::shared_ptr<ThreadPool> pool = VB::inst().GetThreadPool();
+    const int N = Chunk::CHUNK_SIZE;
+
+    auto column_distance = [](int x, int z) { return glm::length(glm::vec2(static_cast<float>(x), static_cast<float>(z))); };
+    auto count_quads = [](const VoxelRenderer::VoxelMesh& mesh)
+    {
+        size_t quads = 0;
+        for (int s = 0; s < VoxelRenderer::MESH_SECTIONS; s++) quads += mesh.sections[s].indices.size() / 6;
+        return quads;
+    };
+
+    // Meshed chunks keep a layer and a column of generated neighbours around them
+    ChunkMap<std::shared_ptr<Chunk>> loaded;
+    auto generate_slab = [&](int x)
+    {
+        std::vector<std::shared_ptr<Chunk>> slab;
+        for (int z = -MAX_RADIUS - 1; z <= MAX_RADIUS + 1; z++)
+        {
+            if (column_distance(x, z) > MAX_RADIUS + 1) continue;
+            for (int y = min_layer - 1; y <= max_layer + 1; y++)
+            {
+                glm::ivec3 chunk_idx(center_idx.x + x, y, center_idx.z + z);
+                slab.push_back(std::make_shared<Chunk>(PackChunkID(chunk_idx), chunk_idx * N));
+            }
+        }
+        for (const std::shared_ptr<Chunk>& chunk : slab)
+            pool->Submit([generated = chunk.get()]() { generated->GenerateChunk(); });
+        pool->WaitIdle();
+        for (std::shared_ptr<Chunk>& chunk : slab) loaded[chunk->GetChunkID()] = std::move(chunk);
+    };
+    auto drop_slab = [&](int x)
+    {
+        for (int z = -MAX_RADIUS - 1; z <= MAX_RADIUS + 1; z++)
+            for (int y = min_layer - 1; y <= max_layer + 1; y++)
+                loaded.Erase(PackChunkID(glm::ivec3(center_idx.x + x, y, center_idx.z + z)));
+    };
+
+    struct Meshed
+    {
+        float distance;
+        int lod;
+        size_t quads;
+        size_t lod0_quads;
+    };
+    std::vector<Meshed> meshed;
+
+    auto start = std::chrono::steady_clock::now();
+    generate_slab(-MAX_RADIUS - 1);
+    generate_slab(-MAX_RADIUS);
+    for (int x = -MAX_RADIUS; x <= MAX_RADIUS; x++)
+    {
+        generate_slab(x + 1);
+
+        size_t first = meshed.size();
+        std::vector<std::pair<const Chunk*, ChunkNeighbours>> jobs;
+        for (int z = -MAX_RADIUS; z <= MAX_RADIUS; z++)
+        {
+            float distance = column_distance(x, z);
+            if (distance > MAX_RADIUS) continue;
+            for (int y = min_layer; y <= max_layer; y++)
+            {
+                glm::ivec3 chunk_idx(center_idx.x + x, y, center_idx.z + z);
+                ChunkID chunk_id = PackChunkID(chunk_idx);
+                ChunkNeighbours neighbours = ChunkNeighbours();
+                const ChunkID steps[6] = { CHUNK_ID_STEP_X, CHUNK_ID_STEP_X, CHUNK_ID_STEP_Y, CHUNK_ID_STEP_Y, CHUNK_ID_STEP_Z, CHUNK_ID_STEP_Z };
+                for (int face = 0; face < 6; face++)
+                {
+                    const std::shared_ptr<Chunk>* neighbour = loaded.Find(face % 2 == 0 ? chunk_id + steps[face] : chunk_id - steps[face]);
+                    neighbours[face] = neighbour ? neighbour->get() : nullptr;
+                }
+
+                jobs.push_back({ loaded.Find(chunk_id)->get(), neighbours });
+                meshed.push_back({ distance, chunk_system->lod_for_chunk(chunk_idx, center_idx), 0, 0 });
+            }
+        }
+
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            pool->Submit([&, i]()
+            {
+                Meshed& result = meshed[first + i];
+                result.quads = count_quads(renderer->GenerateChunkMesh(*jobs[i].first, jobs[i].second, result.lod));
+                result.lod0_quads = result.lod == 0 ? result.quads : count_quads(renderer->GenerateChunkMesh(*jobs[i].first, jobs[i].second, 0));
+            });
+        }
+        pool->WaitIdle();
+
+        drop_slab(x - 1);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::shared_ptr<Logger> logger = VB::inst().GetLogger();
+    char text[192];
+    std::snprintf(text, sizeof(text), "LOD radius %d, layers %d..%d, %zu chunks meshed in %.1f s", chunk_system->GetLODRadius(),
+                  min_layer, max_layer, meshed.size(), seconds);
+    logger->Print(text);
+
+    size_t previous_quads = 0;
+    for (int radius = 4; radius <= MAX_RADIUS; radius *= 2)
+    {
+        size_t chunks = 0, quads = 0, lod0_quads = 0;
+        for (const Meshed& result : meshed)
+        {
+            if (result.distance > radius) continue;
+            chunks++;
+            quads += result.quads;
+            lod0_quads += result.lod0_quads;
+        }
+
+        std::snprintf(text, sizeof(text), "radius %d: %zu chunks, %zu quads, %zu all at lod 0 (%.0f%%)", radius, chunks, quads,
+                      lod0_quads, lod0_quads > 0 ? 100.0 * quads / lod0_quads : 0.0);
+        std::string line = text;
+        if (previous_quads > 0) line += ", +" + std::to_string(quads - previous_quads) + " over radius " + std::to_string(radius / 2);
+        logger->Print(line);
+        previous_quads = quads;
+    }
+}
+
+// ----------<[ TESTRUNNER CLASS IMPLEMENTATION ]>----------
+int TestRunner::Run(const std::string& filter)
+{
+    int run = 0, failed = 0;
+    for (const Test& test : tests())
+    {
+        if (std::string(test.name).find(filter) == std::string::npos) continue;
+
+        auto start = std::chrono::steady_clock::now();
+        std::string message;
+        bool passed = test.function(message);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::string line = std::string(passed ? "PASS " : "FAIL ") + test.name + " (" + std::to_string(static_cast<int>(ms)) + " ms): " + message;
+        if (passed) VB::inst().GetLogger()->Print(line);
+        else VB::inst().GetLogger()->PrintErr(line);
+
+        run++;
+        if (!passed) failed++;
+    }
+
+    VB::inst().GetLogger()->Print(std::to_string(run - failed) + " of " + std::to_string(run) + " tests passed");
+    return failed;
+}
+
+bool TestRunner::RunBenchmark(const std::string& name)
+{
+    for (const Benchmark& benchmark : benchmarks())
+    {
+        if (name != benchmark.name) continue;
+        benchmark.function();
+        return true;
+    }
+
+    std::string names;
+    for (const Benchmark& benchmark : benchmarks()) names += std::string(names.empty() ? "" : ", ") + benchmark.name;
+    VB::inst().GetLogger()->PrintErr("No benchmark called '" + name + "', there are: " + names);
+    return false;
+}
+
+const std::vector<TestRunner::Test>& TestRunner::tests()
+{
+    static const std::vector<Test> tests = {
+        { "chunk_map", test_chunk_map },
+        { "chunk_handles", test_chunk_handles },
+        { "noise_batch", test_noise_batch },
+        { "generation_determinism", test_generation_determinism },
+        { "mesher_golden", test_mesher_golden },
+        { "mesher_quad_ratio", test_mesher_quad_ratio },
+        { "mesher_elision", test_mesher_elision },
+        { "gpu_allocator", test_gpu_allocator },
+        { "frustum", test_frustum },
+        { "occlusion_culler", test_occlusion_culler },
+        { "world_access", test_world_access },
+        { "region_round_trip", test_region_round_trip },
+        { "codec_round_trip", test_codec_round_trip },
+    };
+    return tests;
+}
+
+const std::vector<TestRunner::Benchmark>& TestRunner::benchmarks()
+{
+    static const std::vector<Benchmark> benchmarks = {
+        { "noise", bench_noise },
+        { "terrain", bench_terrain },
+        { "region", bench_region },
+        { "codec", bench_codec },
+        { "occlusion", bench_occlusion },
+        { "lod_rings", bench_lod_rings },
+    };
+    return benchmarks;
+}
@@ -0,0 +1,46 @@
+#ifndef TESTS_H
+#define TESTS_H
+
+#include <string>
+#include <vector>
+
+// Headless checks, run with `VoxelByte --test [filter]` before any window or GL context is created. Each
+//   test returns true if it passed and describes what it found in message. The debug menu's benchmarks
+//   that don't need GL can be run the same way with `VoxelByte --bench <name>`.
+class TestRunner
+{
+public:
+    typedef bool (*TestFunction)(std::string& message);
+
+    struct Test
+    {
+        const char* name;
+        TestFunction function;
+    };
+
+    // Runs every test whose name contains filter, in order, and returns how many failed
+    static int Run(const std::string& filter = "");
+
+    typedef void (*BenchmarkFunction)();
+
+    struct Benchmark
+    {
+        const char* name;
+        BenchmarkFunction function;
+    };
+
+    // Runs the benchmark called name (`VoxelByte --bench <name>`) and logs its results. Returns false,
+    //   listing the benchmarks there are, if there is none by that name.
+    static bool RunBenchmark(const std::string& name);
+
+private:
+    static const std::vector<Test>& tests();
+    static const std::vector<Benchmark>& benchmarks();
+
+    // Tests and benchmarks that need private state, of classes that make TestRunner a friend
+    static bool test_chunk_handles(std::string& message);
+    static bool test_world_access(std::string& message);
+    static void bench_lod_rings();
+};
+
+#endif
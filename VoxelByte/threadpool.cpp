@@ -0,0 +1,90 @@
+#include "globals.h"
+
+ThreadPool::ThreadPool(unsigned int thread_count)
+{
+    if (thread_count == 0)
+    {
+        unsigned int hw_threads = std::thread::hardware_concurrency();
+        thread_count = hw_threads > 1 ? hw_threads - 1 : 1;
+    }
+
+    for (unsigned int i = 0; i < thread_count; i++)
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+
+    VB::inst().GetLogger()->Print("ThreadPool obj constructed with " + std::to_string(thread_count) + " workers");
+}
+
+ThreadPool::~ThreadPool()
+{
+    Shutdown();
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+        m_jobs.push(std::move(job));
+    }
+    m_job_cv.notify_one();
+}
+
+void ThreadPool::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle_cv.wait(lock, [this] { return m_jobs.empty() && m_active_jobs == 0; });
+}
+
+void ThreadPool::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+        m_stopping = true;
+
+        // Jobs that haven't started yet are dropped, running ones are allowed to finish
+        std::queue<std::function<void()>>().swap(m_jobs);
+    }
+    m_job_cv.notify_all();
+
+    for (std::thread& worker : m_workers)
+        if (worker.joinable()) worker.join();
+
+    m_workers.clear();
+}
+
+unsigned int ThreadPool::GetThreadCount() const
+{
+    return static_cast<unsigned int>(m_workers.size());
+}
+
+size_t ThreadPool::GetPendingJobCount()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_jobs.size() + m_active_jobs;
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_job_cv.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) return;
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop();
+            m_active_jobs++;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_active_jobs--;
+            if (m_jobs.empty() && m_active_jobs == 0) m_idle_cv.notify_all();
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <vector>
+
+class ThreadPool
+{
+public:
+    // A thread_count of 0 picks one worker per hardware thread, leaving one for the render thread
+    ThreadPool(unsigned int thread_count = 0);
+    ~ThreadPool();
+
+    void Submit(std::function<void()> job);
+    void WaitIdle();
+    void Shutdown();
+
+    unsigned int GetThreadCount() const;
+    size_t GetPendingJobCount();
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_jobs;
+
+    std::mutex m_mutex;
+    std::condition_variable m_job_cv;
+    std::condition_variable m_idle_cv;
+
+    size_t m_active_jobs = 0;
+    bool m_stopping = false;
+};
+
+#endif
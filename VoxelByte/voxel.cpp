@@ -1,8 +1,13 @@
 #include "globals.h"
 
+#include <cstring>
+#include <optional>
+
 // ----------<[ VOXELRENDERER CLASS IMPLEMENTATION ]>----------
 VoxelRenderer::VoxelRenderer()
 {
+    // Fill the registry up front so mesh workers only ever read it
+    init();
     VB::inst().GetLogger()->Print("VoxelRenderer obj constructed");
 }
 
@@ -68,6 +73,26 @@ void VoxelRenderer::init() {
         .flammable = false,
         .affectedByGravity = false
     };
+    m_voxelRegistry[4] = 
+    { 
+        .name = "sand", 
+        .color = {0.76f, 0.70f, 0.50f}, 
+        .solid = true,
+        .destructible = true,
+        .interactable = false,
+        .flammable = false,
+        .affectedByGravity = true
+    };
+    m_voxelRegistry[5] = 
+    { 
+        .name = "snow", 
+        .color = {0.92f, 0.94f, 0.96f}, 
+        .solid = true,
+        .destructible = true,
+        .interactable = false,
+        .flammable = false,
+        .affectedByGravity = false
+    };
 }
 
 const VoxelRenderer::VoxelData& VoxelRenderer::GetVoxelData(uint8_t voxelId) {
@@ -75,378 +100,2005 @@ const VoxelRenderer::VoxelData& VoxelRenderer::GetVoxelData(uint8_t voxelId) {
     return m_voxelRegistry[voxelId];
 }
 
-int VoxelRenderer::VoxelMesh::AddVertex(float x, float y, float z, uint8_t id)
+int VoxelRenderer::VoxelMesh::AddVertex(int section, int x, int y, int z, uint8_t face, uint8_t id)
 {
-    vertices.push_back(x);
-    vertices.push_back(y);
-    vertices.push_back(z);
-    vertices.push_back(GetVoxelData(id).color.x);
-    vertices.push_back(GetVoxelData(id).color.y);
-    vertices.push_back(GetVoxelData(id).color.z);
-    return static_cast<int>((vertices.size() / 6) - 1);
+    Section& mesh_section = sections[section];
+    mesh_section.vertices.push_back( static_cast<uint32_t>(x) |
+                                     static_cast<uint32_t>(y) << 7 |
+                                     static_cast<uint32_t>(z) << 14 |
+                                     static_cast<uint32_t>(face) << 21 |
+                                     static_cast<uint32_t>(id) << 24);
+    mesh_section.bounds_min = glm::min(mesh_section.bounds_min, glm::ivec3(x, y, z));
+    mesh_section.bounds_max = glm::max(mesh_section.bounds_max, glm::ivec3(x, y, z));
+    return static_cast<int>(mesh_section.vertices.size() - 1);
 }
 
-void VoxelRenderer::VoxelMesh::AddIndex(int v0, int v1, int v2) {
+void VoxelRenderer::VoxelMesh::AddIndex(int section, int v0, int v1, int v2) {
+    std::vector<unsigned int>& indices = sections[section].indices;
     indices.push_back(v0);
     indices.push_back(v1);
     indices.push_back(v2);
 }
 
+size_t VoxelRenderer::VoxelMesh::GetByteSize() const
+{
+    size_t bytes = 0;
+    for (const Section& section : sections)
+        bytes += section.vertices.size() * sizeof(uint32_t) + section.indices.size() * sizeof(unsigned int);
+    return bytes;
+}
+
+bool VoxelRenderer::VoxelMesh::HasSameQuads(const VoxelMesh& other) const
+{
+    // A quad is its four vertices in AddVertex order, the indices only say where they landed
+    auto sorted_quads = [](const Section& section)
+    {
+        std::vector<std::array<uint32_t, 4>> quads;
+        for (size_t i = 0; i + 5 < section.indices.size(); i += 6)
+        {
+            quads.push_back({ section.vertices[section.indices[i]], section.vertices[section.indices[i + 1]],
+                              section.vertices[section.indices[i + 2]], section.vertices[section.indices[i + 5]] });
+        }
+        std::sort(quads.begin(), quads.end());
+        return quads;
+    };
+
+    for (int s = 0; s < MESH_SECTIONS; s++)
+        if (sorted_quads(sections[s]) != sorted_quads(other.sections[s])) return false;
+    return true;
+}
+
 void VoxelRenderer::SetShader(std::shared_ptr<Shader> shader)
 {
     m_voxel_shader = shader;
 }
 
-VoxelRenderer::VoxelMesh VoxelRenderer::GenerateChunkMesh(Chunk chunk)
+VoxelRenderer::VoxelMesh VoxelRenderer::GenerateChunkMesh(const Chunk& chunk, const ChunkNeighbours& neighbours, int lod, uint8_t sections) const
 {
-    VoxelMesh chunkMesh;
+    static_assert(MESH_SECTIONS * MESH_SECTION_HEIGHT == Chunk::CHUNK_SIZE, "mesh sections must cover the chunk");
 
-    // Sweep over each axis (X, Y and Z)
-    for (int d = 0; d < 3; d++)
+    VoxelMesh chunkMesh;
+    chunkMesh.section_mask = sections;
+
+    // Uniform air chunks have no faces at all, everything outside the chunk is treated as air as well
+    uint8_t uniform_id;
+    if (chunk.IsUniform() && chunk.IsSectionUniform(glm::ivec3(0), uniform_id) && !VoxelRenderer::GetVoxelData(uniform_id).solid)
+        return chunkMesh;
+
+    const int N = Chunk::CHUNK_SIZE;
+    const int S = Chunk::SECTION_SIZE;
+
+    // Scratch buffers are reused by each worker thread between chunks
+    thread_local std::vector<uint8_t> voxels;
+    thread_local std::vector<uint64_t> columns;
+    thread_local std::vector<uint64_t> planes;
+    thread_local std::vector<uint64_t> selected;
+    voxels.resize(N * N * N);
+    columns.assign(3 * N * N, 0);
+    planes.resize((N + 1) * N);
+    selected.resize(N);
+
+    // One 64-bit solid mask per column along each axis. For axis d (with u = (d + 1) % 3, v = (d + 2) % 3)
+    //   columns[d][x[u] * N + x[v]] holds bit x[d] for every voxel in that column.
+    uint64_t* column_x = &columns[0 * N * N];   // [y][z], bits along x
+    uint64_t* column_y = &columns[1 * N * N];   // [z][x], bits along y
+    uint64_t* column_z = &columns[2 * N * N];   // [x][y], bits along z
+
+    bool solid[256];
+    for (int id = 0; id < 256; id++) solid[id] = VoxelRenderer::GetVoxelData(static_cast<uint8_t>(id)).solid;
+
+    uint8_t section_voxels[Chunk::SECTION_SIZE * Chunk::SECTION_SIZE * Chunk::SECTION_SIZE];
+    const uint64_t section_bits = (uint64_t(1) << S) - 1;
+
+    for (int sx = 0; sx < Chunk::SECTIONS_PER_AXIS; sx++)
+    for (int sy = 0; sy < Chunk::SECTIONS_PER_AXIS; sy++)
+    for (int sz = 0; sz < Chunk::SECTIONS_PER_AXIS; sz++)
     {
-        int i = 0, j = 0, k = 0, l = 0, w = 0, h = 0;
-        int u = (d + 1) % 3;
-        int v = (d + 2) % 3;
-        int* x = new int[3] {0};
-        int* q = new int[3] {0};
+        int ox = sx * S, oy = sy * S, oz = sz * S;
+
+        // Uniform sections are filled a whole 16-bit run at a time without touching the voxel data. Air
+        //   sections still have to be written, the scratch buffer holds whatever the thread meshed last.
+        if (chunk.IsSectionUniform(glm::ivec3(sx, sy, sz), uniform_id))
+        {
+            for (int a = 0; a < S; a++)
+            {
+                for (int b = 0; b < S; b++)
+                {
+                    std::fill_n(&voxels[(ox + a) * N * N + (oy + b) * N + oz], S, uniform_id);
+                    if (!solid[uniform_id]) continue;
+
+                    column_x[(oy + a) * N + (oz + b)] |= section_bits << ox;
+                    column_y[(oz + a) * N + (ox + b)] |= section_bits << oy;
+                    column_z[(ox + a) * N + (oy + b)] |= section_bits << oz;
+                }
+            }
+            continue;
+        }
 
-        bool* mask = new bool[Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE] {false};
-        q[d] = 1;
+        chunk.CopySection(glm::ivec3(sx, sy, sz), section_voxels);
 
-        // Check each slice of the chunk one at a time
-        for (x[d] = -1; x[d] < Chunk::CHUNK_SIZE;)
+        int n = 0;
+        for (int x = ox; x < ox + S; x++)
         {
-            // Compute the mask
-            int n = 0;
-            for (x[v] = 0; x[v] < Chunk::CHUNK_SIZE; x[v]++)
+            for (int y = oy; y < oy + S; y++)
             {
-                for (x[u] = 0; x[u] < Chunk::CHUNK_SIZE; x[u]++)
+                std::copy_n(&section_voxels[n], S, &voxels[x * N * N + y * N + oz]);
+
+                for (int z = oz; z < oz + S; z++, n++)
                 {
-                    // q determines the direction (X, Y or Z) that we are searching
-                    // m.IsBlockAt(x,y,z) takes global map positions and returns true if a block exists there
+                    if (!solid[section_voxels[n]]) continue;
 
+                    column_x[y * N + z] |= uint64_t(1) << x;
+                    column_y[z * N + x] |= uint64_t(1) << y;
+                    column_z[x * N + y] |= uint64_t(1) << z;
+                }
+            }
+        }
+    }
 
-                    bool blockCurrent;
-                    bool blockCompare;
+    chunkMesh.connectivity = ComputeFaceConnectivity(voxels.data(), N, solid);
 
-                    if (0 <= x[d]) {
-                        uint8_t voxelId = chunk.GetVoxel(glm::ivec3(x[0], x[1], x[2]));
-                        blockCurrent = !VoxelRenderer::GetVoxelData(voxelId).solid;
-                    }
-                    else {
-                        blockCurrent = true;
-                    }
+    // Lower levels of detail mesh a grid of n^3 blocks, each standing in for scale^3 voxels.
+    //   A block is solid if at least half of its voxels are; its id is the most common id among the
+    //   topmost solid voxel of each column, so the surface material wins over what lies underneath.
+    const int n = N >> lod;
+    const int scale = 1 << lod;
 
-                    if (x[d] < (Chunk::CHUNK_SIZE - 1)) {
-                        uint8_t voxelId = chunk.GetVoxel(glm::ivec3(x[0] + q[0], x[1] + q[1], x[2] + q[2]));
-                        blockCompare = !VoxelRenderer::GetVoxelData(voxelId).solid;
-                    }
-                    else {
-                        blockCompare = true;
+    // Quads never cross a mesh section border along y, section_blocks blocks make up one section.
+    //   section_rows holds bit y for every block row in a section that is being generated.
+    const int section_blocks = MESH_SECTION_HEIGHT / scale;
+    uint64_t section_rows = 0;
+    for (int y = 0; y < n; y++)
+        if (sections & (1 << (y / section_blocks))) section_rows |= uint64_t(1) << y;
+
+    auto downsample_block = [&](auto voxel_at, int bx, int by, int bz) -> uint8_t
+    {
+        uint8_t ids[64];
+        int counts[64];
+        int distinct = 0;
+        int solid_count = 0;
+
+        for (int x = bx * scale; x < (bx + 1) * scale; x++)
+        {
+            for (int z = bz * scale; z < (bz + 1) * scale; z++)
+            {
+                bool top_found = false;
+                for (int y = (by + 1) * scale - 1; y >= by * scale; y--)
+                {
+                    uint8_t id = voxel_at(x, y, z);
+                    if (!solid[id]) continue;
+                    solid_count++;
+                    if (top_found) continue;
+                    top_found = true;
+
+                    int i = 0;
+                    while (i < distinct && ids[i] != id) i++;
+                    if (i == distinct)
+                    {
+                        ids[distinct] = id;
+                        counts[distinct++] = 0;
                     }
+                    counts[i]++;
+                }
+            }
+        }
+
+        if (solid_count * 2 < scale * scale * scale) return 0;
+
+        int best = 0;
+        for (int i = 1; i < distinct; i++)
+            if (counts[i] > counts[best]) best = i;
+        return ids[best];
+    };
+
+    const uint8_t* grid = voxels.data();
+    if (lod > 0)
+    {
+        thread_local std::vector<uint8_t> lod_voxels;
+        lod_voxels.resize(n * n * n);
+        auto dense_at = [&](int x, int y, int z) { return voxels[x * N * N + y * N + z]; };
+
+        columns.assign(3 * n * n, 0);
+        column_x = &columns[0 * n * n];
+        column_y = &columns[1 * n * n];
+        column_z = &columns[2 * n * n];
+
+        for (int x = 0; x < n; x++)
+        {
+            for (int y = 0; y < n; y++)
+            {
+                for (int z = 0; z < n; z++)
+                {
+                    uint8_t id = downsample_block(dense_at, x, y, z);
+                    lod_voxels[x * n * n + y * n + z] = id;
+                    if (!solid[id]) continue;
 
-                    // The mask is set to true if there is a visible face between two blocks,
-                    //   i.e. both aren't empty and both aren't blocks
-                    mask[n] = (blockCurrent != blockCompare);
-                    n += 1;
+                    column_x[y * n + z] |= uint64_t(1) << x;
+                    column_y[z * n + x] |= uint64_t(1) << y;
+                    column_z[x * n + y] |= uint64_t(1) << z;
                 }
             }
+        }
+
+        grid = lod_voxels.data();
+    }
+
+    // One block border from each neighbour: neighbour_solid[face][x[v]] holds bit x[u] if the neighbour's
+    //   block touching that face is solid. Faces against a solid neighbour are hidden, missing neighbours count as air.
+    thread_local std::vector<uint64_t> neighbour_solid;
+    neighbour_solid.assign(6 * n, 0);
+
+    for (int face = 0; face < 6; face++)
+    {
+        const Chunk* neighbour = neighbours[face];
+        if (!neighbour) continue;
+
+        int d = face / 2;
+        int u = (d + 1) % 3;
+        int v = (d + 2) % 3;
+        auto neighbour_at = [neighbour](int x, int y, int z) { return neighbour->GetVoxel(glm::ivec3(x, y, z)); };
+
+        int x[3] = { 0 };
+        x[d] = (face % 2 == 0) ? 0 : n - 1;
+        for (x[v] = 0; x[v] < n; x[v]++)
+        {
+            uint64_t row = 0;
+            for (x[u] = 0; x[u] < n; x[u]++)
+            {
+                uint8_t id = lod > 0 ? downsample_block(neighbour_at, x[0], x[1], x[2]) : neighbour_at(x[0], x[1], x[2]);
+                if (solid[id]) row |= uint64_t(1) << x[u];
+            }
+            neighbour_solid[face * n + x[v]] = row;
+        }
+    }
+
+    // Sweep over each axis (X, Y and Z), once per face direction
+    for (int d = 0; d < 3; d++)
+    {
+        int u = (d + 1) % 3;
+        int v = (d + 2) % 3;
+        const uint64_t* column = &columns[d * n * n];
+
+        int stride[3] = { n * n, n, 1 };
 
-            x[d]++;
+        for (int dir = 0; dir < 2; dir++)
+        {
+            bool positive = (dir == 0);
+            uint8_t face = static_cast<uint8_t>(d * 2 + dir);
+
+            // planes[k][x[v]] holds one bit per x[u] for every face on the plane x[d] = k (0..n).
+            //   Faces belong to the solid voxel: a +d face of voxel c lies on plane c + 1, a -d face on plane c.
+            //   The neighbour border fills in the voxel just past either end of the column.
+            std::fill(planes.begin(), planes.end(), 0);
+            const uint64_t* border = &neighbour_solid[face * n];
+
+            for (int cu = 0; cu < n; cu++)
+            {
+                for (int cv = 0; cv < n; cv++)
+                {
+                    uint64_t col = column[cu * n + cv];
+                    if (col == 0) continue;
 
-            n = 0;
+                    uint64_t border_bit = (border[cv] >> cu) & 1;
+                    uint64_t faces = positive ? col & ~((col >> 1) | (border_bit << (n - 1)))
+                                              : col & ~((col << 1) | border_bit);
+                    while (faces)
+                    {
+                        int c = std::countr_zero(faces);
+                        planes[(positive ? c + 1 : c) * n + cv] |= uint64_t(1) << cu;
+                        faces &= faces - 1;
+                    }
+                }
+            }
 
-            // Generate a mesh from the mask using lexicographic ordering,      
-            //   by looping over each block in this slice of the chunk
-            for (j = 0; j < Chunk::CHUNK_SIZE; j++)
+            for (int k = 0; k <= n; k++)
             {
-                for (i = 0; i < Chunk::CHUNK_SIZE;)
+                // No voxel sits behind the outermost plane in this direction
+                if (positive ? k == 0 : k == n) continue;
+
+                // Y faces belong to the section of the voxel behind them
+                if (d == 1 && !((section_rows >> (positive ? k - 1 : k)) & 1)) continue;
+
+                uint64_t* rows = &planes[k * n];
+
+                // X faces run along y within each row, Z faces have a row per y
+                if (sections != ALL_MESH_SECTIONS)
                 {
-                    if (mask[n])
+                    for (int j = 0; j < n; j++)
                     {
-                        // Compute the width of this quad and store it in w                        
-                        //   This is done by searching along the current axis until mask[n + w] is false
-                        for (w = 1; ((i + w) < Chunk::CHUNK_SIZE) && mask[n + w]; w++) {}
+                        if (u == 1) rows[j] &= section_rows;
+                        else if (v == 1 && !((section_rows >> j) & 1)) rows[j] = 0;
+                    }
+                }
 
-                        // Compute the height of this quad and store it in h                        
-                        //   This is done by checking if every block next to this row (range 0 to w) is also part of the mask.
-                        //   For example, if w is 5 we currently have a quad of dimensions 1 x 5. To reduce triangle count,
-                        //   greedy meshing will attempt to expand this quad out to CHUNK_SIZE x 5, but will stop if it reaches a hole in the mask
+                // Voxel id of the solid voxel behind the face at (i, j) on this plane
+                const uint8_t* plane_voxels = &grid[(positive ? k - 1 : k) * stride[d]];
+                auto face_id = [&](int i, int j) { return plane_voxels[i * stride[u] + j * stride[v]]; };
+
+                for (int j = 0; j < n; j++)
+                {
+                    while (rows[j])
+                    {
+                        // Pull every remaining face with the same voxel id as the first one out of the plane,
+                        //   so quads only ever merge faces of a single material
+                        uint8_t id = face_id(std::countr_zero(rows[j]), j);
 
-                        bool done = false;
-                        for (h = 1; (j + h) < Chunk::CHUNK_SIZE; h++)
+                        for (int jj = j; jj < n; jj++)
                         {
-                            // Check each block next to this quad
-                            for (k = 0; k < w; k++)
+                            uint64_t bits = rows[jj];
+                            uint64_t match = 0;
+                            while (bits)
                             {
-                                // If there's a hole in the mask, exit
-                                if (!mask[n + k + h * Chunk::CHUNK_SIZE])
-                                {
-                                    done = true;
-                                    break;
-                                }
+                                int i = std::countr_zero(bits);
+                                if (face_id(i, jj) == id) match |= uint64_t(1) << i;
+                                bits &= bits - 1;
                             }
-
-                            if (done)
-                                break;
+                            selected[jj] = match;
+                            rows[jj] &= ~match;
                         }
 
-                        x[u] = i;
-                        x[v] = j;
-
-                        // du and dv determine the size and orientation of this face
-                        int* du = new int[3] {0};
-                        du[u] = w;
+                        // Greedy mesh the selected faces in lexicographic order (rows along v, bits along u)
+                        for (int sj = j; sj < n; sj++)
+                        {
+                            while (selected[sj])
+                            {
+                                // Width is the run of set bits starting at the lowest face left in this row
+                                int i = std::countr_zero(selected[sj]);
+                                int w = std::countr_one(selected[sj] >> i);
+                                if (u == 1) w = std::min(w, (i / section_blocks + 1) * section_blocks - i);
+                                uint64_t run = (w == 64 ? ~uint64_t(0) : ((uint64_t(1) << w) - 1)) << i;
+
+                                // Height grows while the next row contains the whole run, clearing it as we go
+                                //   so the same faces aren't added twice
+                                selected[sj] &= ~run;
+                                int h = 1;
+                                while (sj + h < n && (selected[sj + h] & run) == run && !(v == 1 && (sj + h) % section_blocks == 0))
+                                {
+                                    selected[sj + h] &= ~run;
+                                    h++;
+                                }
 
-                        int* dv = new int[3] {0};
-                        dv[v] = h;
+                                int x[3] = { 0 };
+                                x[d] = k * scale;
+                                x[u] = i * scale;
+                                x[v] = sj * scale;
 
-                        // Create a quad for this face. Colour, normal or textures are not stored in this block vertex format.
+                                // du and dv determine the size and orientation of this face
+                                int du[3] = { 0 };
+                                du[u] = w * scale;
 
-                        int v0 = chunkMesh.AddVertex((float)(x[0]), (float)(x[1]), (float)(x[2]), voxelId);
-                        int v1 = chunkMesh.AddVertex((float)(x[0] + du[0]), (float)(x[1] + du[1]), (float)(x[2] + du[2]), voxelId);
-                        int v2 = chunkMesh.AddVertex((float)(x[0] + dv[0]), (float)(x[1] + dv[1]), (float)(x[2] + dv[2]), voxelId);
-                        int v3 = chunkMesh.AddVertex((float)(x[0] + du[0] + dv[0]), (float)(x[1] + du[1] + dv[1]), (float)(x[2] + du[2] + dv[2]), voxelId);
-                        chunkMesh.AddIndex(v0, v1, v2);
-                        chunkMesh.AddIndex(v1, v2, v3);
+                                int dv[3] = { 0 };
+                                dv[v] = h * scale;
 
-                        // Clear this part of the mask, so we don't add duplicate faces
-                        for (l = 0; l < h; l++)
-                            for (k = 0; k < w; k++)
-                                mask[n + k + l * Chunk::CHUNK_SIZE] = false;
+                                // Lowest y of the voxels behind the quad, a +Y face sits on top of its voxel
+                                int section = (d == 1 && positive ? x[1] - scale : x[1]) / MESH_SECTION_HEIGHT;
 
-                        // Increment counters and continue
-                        i += w;
-                        n += w;
-                    }
-                    else
-                    {
-                        i++;
-                        n++;
+                                int v0 = chunkMesh.AddVertex(section, x[0], x[1], x[2], face, id);
+                                int v1 = chunkMesh.AddVertex(section, x[0] + du[0], x[1] + du[1], x[2] + du[2], face, id);
+                                int v2 = chunkMesh.AddVertex(section, x[0] + dv[0], x[1] + dv[1], x[2] + dv[2], face, id);
+                                int v3 = chunkMesh.AddVertex(section, x[0] + du[0] + dv[0], x[1] + du[1] + dv[1], x[2] + du[2] + dv[2], face, id);
+                                chunkMesh.AddIndex(section, v0, v1, v2);
+                                chunkMesh.AddIndex(section, v1, v2, v3);
+                            }
+                        }
                     }
                 }
             }
         }
     }
 
-    VB::inst().GetLogger()->Print("Chunk mesh generated. Vtx: " + std::to_string(chunkMesh.vertices.size()) + " Idx: " + std::to_string(chunkMesh.indices.size()));
+    size_t vertex_count = 0, index_count = 0;
+    for (const VoxelMesh::Section& section : chunkMesh.sections)
+    {
+        vertex_count += section.vertices.size();
+        index_count += section.indices.size();
+    }
+    VB::inst().GetLogger()->Print("Chunk mesh generated. Vtx: " + std::to_string(vertex_count) + " Idx: " + std::to_string(index_count));
     return chunkMesh;
 }
 
-void VoxelRenderer::BufferVoxelMesh(const ChunkID& chunk_id, VoxelMesh& mesh)
+VoxelRenderer::VoxelMesh VoxelRenderer::GenerateChunkMeshReference(const Chunk& chunk, const ChunkNeighbours& neighbours) const
 {
-    if (VoxelRendererBufferInfoMap.find(chunk_id) != VoxelRendererBufferInfoMap.end()) return;
-
-    if (VoxelRendererVAO == 0) glGenVertexArrays(1, &VoxelRendererVAO);
+    VoxelMesh chunkMesh;
 
-    GLuint CurrentMeshVBO, CurrentMeshEBO;
+    const int N = Chunk::CHUNK_SIZE;
+    const int S = Chunk::SECTION_SIZE;
 
-    glBindVertexArray(VoxelRendererVAO);
+    // Dense copy of the chunk, the same input the bitmask mesher starts from
+    std::vector<uint8_t> voxels(N * N * N);
+    uint8_t section_voxels[Chunk::SECTION_SIZE * Chunk::SECTION_SIZE * Chunk::SECTION_SIZE];
+    for (int sx = 0; sx < Chunk::SECTIONS_PER_AXIS; sx++)
+    for (int sy = 0; sy < Chunk::SECTIONS_PER_AXIS; sy++)
+    for (int sz = 0; sz < Chunk::SECTIONS_PER_AXIS; sz++)
+    {
+        chunk.CopySection(glm::ivec3(sx, sy, sz), section_voxels);
+        for (int x = 0; x < S; x++)
+            for (int y = 0; y < S; y++)
+                std::copy_n(&section_voxels[x * S * S + y * S], S, &voxels[(sx * S + x) * N * N + (sy * S + y) * N + sz * S]);
+    }
 
-    glGenBuffers(1, &CurrentMeshVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, CurrentMeshVBO);
-    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(float), mesh.vertices.data(), GL_STATIC_DRAW);
+    bool solid[256];
+    for (int id = 0; id < 256; id++) solid[id] = VoxelRenderer::GetVoxelData(static_cast<uint8_t>(id)).solid;
 
-    glGenBuffers(1, &CurrentMeshEBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, CurrentMeshEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(unsigned int), mesh.indices.data(), GL_STATIC_DRAW);
+    // One past the border is the neighbour's voxel if it's loaded, air otherwise
+    auto solid_at = [&](int x, int y, int z)
+    {
+        if (x >= 0 && y >= 0 && z >= 0 && x < N && y < N && z < N) return solid[voxels[x * N * N + y * N + z]];
 
-    VoxelRenderBufferInfo VRBI;
-    VRBI.VBO = CurrentMeshVBO;
-    VRBI.EBO = CurrentMeshEBO;
-    VRBI.chunk_id = chunk_id;
-    VRBI.vtx_size = mesh.vertices.size();
-    VRBI.idx_size = mesh.indices.size();
-    VRBI.chunk_origin = VB::inst().GetMultiChunkSystem()->GetChunkOrigin(chunk_id);
+        int face = x >= N ? FACE_POS_X : x < 0 ? FACE_NEG_X : y >= N ? FACE_POS_Y : y < 0 ? FACE_NEG_Y : z >= N ? FACE_POS_Z : FACE_NEG_Z;
+        const Chunk* neighbour = neighbours[face];
+        return neighbour != nullptr && solid[neighbour->GetVoxel(glm::ivec3((x + N) % N, (y + N) % N, (z + N) % N))];
+    };
 
-    VoxelRendererBufferInfoMap.insert(std::make_pair(chunk_id, VRBI));
+    // mask[j * N + i] is the voxel id behind the visible face at (u = i, v = j) on one slice, -1 for no face
+    std::vector<int> mask(N * N);
 
-    glBindVertexArray(0);
-}
+    for (int d = 0; d < 3; d++)
+    {
+        int u = (d + 1) % 3;
+        int v = (d + 2) % 3;
 
-void VoxelRenderer::DeleteVoxelMesh(const ChunkID& chunk_id)
-{
-    if (VoxelRendererBufferInfoMap.find(chunk_id) == VoxelRendererBufferInfoMap.end()) return;
-    VoxelRenderBufferInfo CurrentMeshBufferInfo = VoxelRendererBufferInfoMap.at(chunk_id);
+        for (int dir = 0; dir < 2; dir++)
+        {
+            bool positive = (dir == 0);
+            uint8_t face = static_cast<uint8_t>(d * 2 + dir);
 
-    glDeleteBuffers(1, &CurrentMeshBufferInfo.VBO);
-    glDeleteBuffers(1, &CurrentMeshBufferInfo.EBO);
+            for (int c = 0; c < N; c++)
+            {
+                int x[3] = { 0 };
+                x[d] = c;
+                for (x[v] = 0; x[v] < N; x[v]++)
+                {
+                    for (x[u] = 0; x[u] < N; x[u]++)
+                    {
+                        uint8_t id = voxels[x[0] * N * N + x[1] * N + x[2]];
+                        int q[3] = { x[0], x[1], x[2] };
+                        q[d] += positive ? 1 : -1;
+                        mask[x[v] * N + x[u]] = solid[id] && !solid_at(q[0], q[1], q[2]) ? id : -1;
+                    }
+                }
 
-    VoxelRendererBufferInfoMap.erase(chunk_id);
-}
+                // Lexicographic greedy merge, width along u first and then height along v
+                for (int j = 0; j < N; j++)
+                {
+                    for (int i = 0; i < N; )
+                    {
+                        int id = mask[j * N + i];
+                        if (id < 0)
+                        {
+                            i++;
+                            continue;
+                        }
 
-void VoxelRenderer::RenderMesh(const ChunkID& chunk_id)
-{
-    if (VoxelRendererBufferInfoMap.find(chunk_id) == VoxelRendererBufferInfoMap.end()) return;
-    VoxelRenderBufferInfo CurrentMeshBufferInfo = VoxelRendererBufferInfoMap.at(chunk_id);
+                        int w = 1;
+                        while (i + w < N && mask[j * N + i + w] == id && !(u == 1 && (i + w) % MESH_SECTION_HEIGHT == 0)) w++;
 
-    glBindVertexArray(VoxelRendererVAO);
+                        int h = 1;
+                        while (j + h < N && !(v == 1 && (j + h) % MESH_SECTION_HEIGHT == 0))
+                        {
+                            bool row_matches = true;
+                            for (int k = 0; k < w && row_matches; k++) row_matches = mask[(j + h) * N + i + k] == id;
+                            if (!row_matches) break;
+                            h++;
+                        }
 
-    // position attribute
-    glEnableVertexAttribArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, CurrentMeshBufferInfo.VBO);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+                        for (int l = 0; l < h; l++)
+                            for (int k = 0; k < w; k++)
+                                mask[(j + l) * N + i + k] = -1;
 
-    // color attribute
-    glEnableVertexAttribArray(1);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, CurrentMeshBufferInfo.EBO);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+                        int p[3] = { 0 };
+                        p[d] = positive ? c + 1 : c;
+                        p[u] = i;
+                        p[v] = j;
 
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(CurrentMeshBufferInfo.idx_size * 3), GL_UNSIGNED_INT, 0);
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glBindVertexArray(0);
-}
+                        int du[3] = { 0 };
+                        du[u] = w;
 
-void VoxelRenderer::RenderAllMeshes()
-{
-    if (m_voxel_shader == nullptr) return;
-    //m_voxel_shader->use();
+                        int dv[3] = { 0 };
+                        dv[v] = h;
 
-    for (const auto& render_item : VoxelRendererBufferInfoMap)
-    {
-        m_voxel_shader->setFloat3(  "pos_offset",
-                                    static_cast<float>(render_item.second.chunk_origin.x),
-                                    static_cast<float>(render_item.second.chunk_origin.y),
-                                    static_cast<float>(render_item.second.chunk_origin.z));
+                        int section = (d == 1 ? c : p[1]) / MESH_SECTION_HEIGHT;
+                        uint8_t voxel_id = static_cast<uint8_t>(id);
+                        int v0 = chunkMesh.AddVertex(section, p[0], p[1], p[2], face, voxel_id);
+                        int v1 = chunkMesh.AddVertex(section, p[0] + du[0], p[1] + du[1], p[2] + du[2], face, voxel_id);
+                        int v2 = chunkMesh.AddVertex(section, p[0] + dv[0], p[1] + dv[1], p[2] + dv[2], face, voxel_id);
+                        int v3 = chunkMesh.AddVertex(section, p[0] + du[0] + dv[0], p[1] + du[1] + dv[1], p[2] + du[2] + dv[2], face, voxel_id);
+                        chunkMesh.AddIndex(section, v0, v1, v2);
+                        chunkMesh.AddIndex(section, v1, v2, v3);
 
-        RenderMesh(render_item.first);
+                        i += w;
+                    }
+                }
+            }
+        }
     }
+
+    return chunkMesh;
 }
 
-void VoxelRenderer::FreeRenderMeshes()
+// Copies of a chunk and the neighbours its mesh depends on, owned by the mesh job
+struct MeshSnapshot
 {
-    for (const auto& render_item : VoxelRendererBufferInfoMap) DeleteVoxelMesh(render_item.first);
-    glDeleteVertexArrays(1, &VoxelRendererVAO);
-}
+    Chunk chunk;
+    std::array<std::optional<Chunk>, 6> neighbours;
+};
 
-// ----------<[ CHUNK CLASS IMPLEMENTATION ]>----------
-Chunk::Chunk(ChunkID chunk_id, glm::ivec3 origin)
+void VoxelRenderer::QueueChunkMesh(const ChunkID& chunk_id)
 {
-    m_chunkID = chunk_id;
-    m_origin = origin;
+    std::shared_ptr<MultiChunkSystem> chunk_system = VB::inst().GetMultiChunkSystem();
+    const Chunk* chunk = chunk_system->GetChunk(chunk_id);
+    if (!chunk) return;
 
-    m_voxelArray.resize(Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE);
-    VB::inst().GetLogger()->Print("Chunk obj with ID: " + std::to_string(chunk_id) + " constructed");
-}
+    int lod = chunk_system->GetChunkLOD(chunk_id);
+    ChunkNeighbours neighbours = mesh_neighbours(chunk_id, lod);
 
-glm::ivec3 Chunk::getOrigin()
-{
-    return m_origin;
-}
+    // The job works on copies taken here on the main thread, so chunks can be evicted (or edited) while
+    //   it runs. Palette storage keeps the copies small, uniform sections cost nothing.
+    MeshSnapshot snapshot{ *chunk, {} };
+    for (int face = 0; face < 6; face++)
+        if (neighbours[face]) snapshot.neighbours[face] = *neighbours[face];
 
-void Chunk::SetVoxel(glm::ivec3 pos, const uint8_t& id)
-{
-    m_voxelArray.at(pos.x * CHUNK_SIZE * CHUNK_SIZE + pos.y * CHUNK_SIZE + pos.z) = id;
-}
+    uint64_t revision = m_next_mesh_revision++;
+    m_mesh_revisions[chunk_id] = revision;
 
-uint8_t Chunk::GetVoxel(glm::ivec3 pos) const
-{
-    return m_voxelArray.at(pos.x * CHUNK_SIZE * CHUNK_SIZE + pos.y * CHUNK_SIZE + pos.z);
+    VB::inst().GetThreadPool()->Submit([this, snapshot = std::move(snapshot), lod, revision]()
+    {
+        ChunkNeighbours snapshot_neighbours = {};
+        for (int face = 0; face < 6; face++)
+            if (snapshot.neighbours[face]) snapshot_neighbours[face] = &*snapshot.neighbours[face];
+
+        VoxelMesh mesh = GenerateChunkMesh(snapshot.chunk, snapshot_neighbours, lod);
+
+        std::lock_guard<std::mutex> lock(m_mesh_mutex);
+        m_completed_meshes.push_back({ snapshot.chunk.GetChunkID(), revision, std::move(mesh) });
+    });
 }
 
-void Chunk::GenerateChunk()
+void VoxelRenderer::RemeshEditedChunks(const std::vector<EditedChunk>& edited_chunks)
 {
-    if (m_generated == true) return;
-    m_generated = true;
+    if (edited_chunks.empty()) return;
+
+    std::shared_ptr<MultiChunkSystem> chunk_system = VB::inst().GetMultiChunkSystem();
+    auto start = std::chrono::steady_clock::now();
 
-    for (int x = 0; x < Chunk::CHUNK_SIZE; x++)
+    EditStats stats;
+    for (const EditedChunk& edited : edited_chunks)
     {
-        for (int z = 0; z < Chunk::CHUNK_SIZE; z++)
+        const Chunk* chunk = chunk_system->GetChunk(edited.chunk_id);
+        if (!chunk) continue;
+
+        // Patching a few sections relies on the rest of the buffered mesh being current, which isn't the case
+        //   while a newer mesh is still in flight. Lower LODs mesh blocks that reach across the section borders
+        //   an edit marks, so those chunks are remeshed whole as well.
+        int lod = chunk_system->GetChunkLOD(edited.chunk_id);
+        const VoxelRenderBufferInfo* info = VoxelRendererBufferInfoMap.Find(edited.chunk_id);
+        const uint64_t* revision = m_mesh_revisions.Find(edited.chunk_id);
+        uint8_t sections = ALL_MESH_SECTIONS;
+        if (lod == 0 && info && revision && *revision == info->revision)
         {
-            float height_noise = VB::inst().GetNoiseGenerator()->GetNoise().GetNoise(static_cast<float>(m_origin.x + x), static_cast<float>(m_origin.z + z));
+            sections = 0;
+            for (int sy = 0; sy < MESH_SECTIONS; sy++)
+                if (edited.sections & (uint64_t(0x000F000F000F000F) << (sy * Chunk::SECTIONS_PER_AXIS))) sections |= 1 << sy;
+        }
 
-            for (int y = 0; y < Chunk::CHUNK_SIZE; y++)
-            {
-                uint8_t v_id;
+        // The chunks are only touched on this thread, so the mesher can read them directly without snapshots
+        VoxelMesh mesh = GenerateChunkMesh(*chunk, mesh_neighbours(edited.chunk_id, lod), lod, sections);
 
-                if ((height_noise + 1.0f) * 32.0f > y)
-                    v_id = 1;
-                else
-                    v_id = 0;
+        // Anything still in flight for the chunk predates the edit
+        m_mesh_revisions[edited.chunk_id] = m_next_mesh_revision++;
+        BufferVoxelMesh(edited.chunk_id, mesh);
 
-                SetVoxel(glm::vec3(x, y, z), v_id);
-            }
-        }
+        stats.chunks++;
+        stats.sections += std::popcount(sections);
+        stats.bytes += mesh.GetByteSize();
     }
+
+    stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_last_edit_stats = stats;
 }
 
-// ----------<[ MULTICHUNK CLASS IMPLEMENTATION ]>----------
-MultiChunkSystem::MultiChunkSystem()
+const VoxelRenderer::EditStats& VoxelRenderer::GetLastEditStats() const
 {
-    VB::inst().GetLogger()->Print("MultiChunk obj constructed");
+    return m_last_edit_stats;
 }
 
-void MultiChunkSystem::update()
+const VoxelRenderer::MesherBenchmarkResult& VoxelRenderer::RunMesherBenchmark(int chunks_per_axis, int repeats)
 {
-    // get nearest chunk indices in range
-    glm::ivec2 nearest_chunk_idx;
-    nearest_chunk_idx = pos_to_nearest_chunk_idx(VB::inst().GetCamera()->Position);
-    
-    for (int x = -m_chunk_gen_radius; x < m_chunk_gen_radius; x++)
+    MesherBenchmarkResult result;
+    result.valid = true;
+    result.repeats = repeats;
+
+    // Far from where the camera starts, spanning the surface and the caves below it
+    const glm::ivec3 base_idx(-4096, -2, 4096);
+    const int n = chunks_per_axis;
+
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    for (int x = 0; x < n; x++)
     {
-        for (int z = -m_chunk_gen_radius; z < m_chunk_gen_radius; z++)
+        for (int y = 0; y < n; y++)
+        {
+            for (int z = 0; z < n; z++)
+            {
+                glm::ivec3 chunk_idx = base_idx + glm::ivec3(x, y, z);
+                chunks.push_back(std::make_unique<Chunk>(PackChunkID(chunk_idx), chunk_idx * Chunk::CHUNK_SIZE));
+                chunks.back()->GenerateChunk();
+            }
+        }
+    }
+    result.chunks = chunks.size();
+
+    // Neighbours within the block, so border faces get culled like they are in the world
+    std::vector<ChunkNeighbours> neighbours(chunks.size());
+    const glm::ivec3 face_steps[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    for (int i = 0; i < static_cast<int>(chunks.size()); i++)
+    {
+        glm::ivec3 idx(i / (n * n), i / n % n, i % n);
+        for (int face = 0; face < 6; face++)
         {
-            glm::ivec2 pawsible_chunk_idx(  nearest_chunk_idx.x + x,
-                                            nearest_chunk_idx.y + z);
+            glm::ivec3 other = idx + face_steps[face];
+            if (glm::all(glm::greaterThanEqual(other, glm::ivec3(0))) && glm::all(glm::lessThan(other, glm::ivec3(n))))
+                neighbours[i][face] = chunks[other.x * n * n + other.y * n + other.z].get();
+        }
+    }
+
+    std::vector<VoxelMesh> meshes(chunks.size());
+    std::vector<VoxelMesh> reference_meshes(chunks.size());
 
-            if (glm::distance(glm::vec2(nearest_chunk_idx), glm::vec2(pawsible_chunk_idx)) > static_cast<float>(m_chunk_gen_radius)) continue;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        for (size_t i = 0; i < chunks.size(); i++) meshes[i] = GenerateChunkMesh(*chunks[i], neighbours[i]);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-            ChunkID curr_id = chunk_idx_id(pawsible_chunk_idx);
-            std::shared_ptr<Chunk> curr_chunk = std::make_shared<Chunk>(curr_id, glm::ivec3(chunk_idx_to_origin(pawsible_chunk_idx).x, 0, chunk_idx_to_origin(pawsible_chunk_idx).y));
-            curr_chunk->GenerateChunk();
-            m_chunk_list.insert({curr_id, std::move(curr_chunk)});
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        for (size_t i = 0; i < chunks.size(); i++) reference_meshes[i] = GenerateChunkMeshReference(*chunks[i], neighbours[i]);
+    result.reference_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-            VB::inst().GetLogger()->Print("ChunkId: " + std::to_string(curr_id) + " X: " + std::to_string(pawsible_chunk_idx.x) + " Y: " + std::to_string(pawsible_chunk_idx.y));
-            VB::inst().GetLogger()->Print("Origin X: " + std::to_string(chunk_idx_to_origin(pawsible_chunk_idx).x) + " Z: " + std::to_string(chunk_idx_to_origin(pawsible_chunk_idx).y));
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        for (int s = 0; s < MESH_SECTIONS; s++)
+        {
+            result.quads += meshes[i].sections[s].indices.size() / 6;
+            result.reference_quads += reference_meshes[i].sections[s].indices.size() / 6;
         }
+        if (!meshes[i].HasSameQuads(reference_meshes[i])) result.mismatched_chunks++;
     }
+
+    m_last_mesher_benchmark = result;
+    VB::inst().GetLogger()->Print("Mesher benchmark: " + std::to_string(result.seconds * 1000.0) + " ms bitmask, " +
+                                  std::to_string(result.reference_seconds * 1000.0) + " ms greedy, " +
+                                  std::to_string(result.mismatched_chunks) + " chunks differ");
+    return m_last_mesher_benchmark;
 }
 
-glm::ivec2 MultiChunkSystem::pos_to_nearest_chunk_idx(glm::vec3 camera_position)
+const VoxelRenderer::MesherBenchmarkResult& VoxelRenderer::GetLastMesherBenchmark() const
 {
-    glm::ivec2 idx;
-    if (camera_position.x < 0.0f) idx.x = static_cast<int>((camera_position.x - Chunk::CHUNK_SIZE) / Chunk::CHUNK_SIZE);
-    else idx.x = static_cast<int>(camera_position.x / Chunk::CHUNK_SIZE);
-    if (camera_position.z < 0.0f) idx.y = static_cast<int>((camera_position.z - Chunk::CHUNK_SIZE) / Chunk::CHUNK_SIZE);
-    else idx.y = static_cast<int>(camera_position.z / Chunk::CHUNK_SIZE);
-
-    return idx;
+    return m_last_mesher_benchmark;
 }
 
-const std::unordered_map<ChunkID, std::shared_ptr<Chunk>>& MultiChunkSystem::get_chunk_map() const
+void VoxelRenderer::UploadPendingMeshes()
 {
-    return m_chunk_list;
+    size_t uploaded_bytes = 0;
+    int uploaded_meshes = 0;
+
+    while (uploaded_meshes < m_upload_budget_meshes)
+    {
+        CompletedMesh completed;
+        {
+            std::lock_guard<std::mutex> lock(m_mesh_mutex);
+            if (m_completed_meshes.empty()) break;
+
+            // A newer mesh for this chunk has been queued since, or the chunk is gone. Dropped before the
+            //   budget is charged, so stale meshes can't hold back the uploads behind them.
+            const CompletedMesh& next = m_completed_meshes.front();
+            const uint64_t* revision = m_mesh_revisions.Find(next.chunk_id);
+            if (!revision || *revision != next.revision)
+            {
+                m_completed_meshes.pop_front();
+                continue;
+            }
+
+            // Always let at least one mesh through so a mesh larger than the budget can't stall the queue
+            size_t next_bytes = next.mesh.GetByteSize();
+            if (uploaded_meshes > 0 && uploaded_bytes + next_bytes > m_upload_budget_bytes) break;
+
+            completed = std::move(m_completed_meshes.front());
+            m_completed_meshes.pop_front();
+            uploaded_bytes += next_bytes;
+        }
+
+        BufferVoxelMesh(completed.chunk_id, completed.mesh);
+        uploaded_meshes++;
+    }
+
+    // Background compaction, a bounded number of bytes moved per frame
+    if (VoxelRendererVAO != 0)
+    {
+        compact_arena(m_vertex_arena, COMPACTION_BYTES_PER_FRAME);
+        compact_arena(m_index_arena, COMPACTION_BYTES_PER_FRAME);
+    }
 }
 
-glm::ivec2 MultiChunkSystem::chunk_idx_to_origin(glm::ivec2 chunk_idx)
+void VoxelRenderer::SetUploadBudget(size_t max_bytes, int max_meshes)
 {
-    return glm::ivec2(  chunk_idx.x * Chunk::CHUNK_SIZE,
-                        chunk_idx.y * Chunk::CHUNK_SIZE);
+    m_upload_budget_bytes = max_bytes;
+    m_upload_budget_meshes = max_meshes;
 }
 
-inline ChunkID MultiChunkSystem::chunk_idx_id(glm::ivec2 chunk_idx)
+size_t VoxelRenderer::GetPendingUploadCount()
 {
-    ChunkID id;
-    id = chunk_idx.x;
-    id = id << 32;
-    id = id | chunk_idx.y;
-    return id;
+    std::lock_guard<std::mutex> lock(m_mesh_mutex);
+    return m_completed_meshes.size();
 }
 
-const glm::ivec3 MultiChunkSystem::GetChunkOrigin(const ChunkID& chunk_id)
+VoxelRenderer::MeshStats VoxelRenderer::GetMeshStats() const
 {
-    if (m_chunk_list.find(chunk_id) == m_chunk_list.end()) return glm::ivec3(0, 0, 0);
-    else return m_chunk_list.at(chunk_id)->getOrigin();
+    MeshStats stats;
+    for (const auto& render_item : VoxelRendererBufferInfoMap)
+    {
+        stats.meshes++;
+        for (const VoxelRenderBufferInfo::Section& section : render_item.second.sections)
+        {
+            if (section.idx_size > 0) stats.sections++;
+            stats.vertices += section.vtx_size;
+            stats.indices += section.idx_size;
+        }
+    }
+
+    // Every quad is 4 vertices and 6 indices
+    stats.quads = stats.indices / 6;
+    stats.bytes = stats.vertices * sizeof(uint32_t) + stats.indices * sizeof(unsigned int);
+    stats.arena_bytes = m_vertex_arena.allocator.GetCapacity() * m_vertex_arena.element_size +
+                        m_index_arena.allocator.GetCapacity() * m_index_arena.element_size +
+                        m_page_origins.size() * sizeof(glm::ivec4);
+    return stats;
 }
 
-// ----------<[ NOISEGENERATOR CLASS IMPLEMENTATION ]>----------
-NoiseGenerator::NoiseGenerator()
+VoxelRenderer::ArenaStats VoxelRenderer::GetArenaStats() const
 {
-    m_noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    ArenaStats stats;
+    stats.vertices = m_vertex_arena.allocator.GetStats();
+    stats.indices = m_index_arena.allocator.GetStats();
+    stats.reused_in_place = m_reused_in_place;
+    stats.compaction_moves = m_compaction_moves;
+
+    // Sections without quads hold no range, so only non-empty ones round up to whole pages
+    for (const auto& render_item : VoxelRendererBufferInfoMap)
+    {
+        for (const VoxelRenderBufferInfo::Section& section : render_item.second.sections)
+        {
+            if (section.vtx_offset == GpuAllocator::INVALID_OFFSET) continue;
+            stats.page_padding_vertices += m_vertex_arena.allocator.GetAllocationSize(section.vtx_offset) - section.vtx_size;
+        }
+    }
+    return stats;
 }
 
-FastNoiseLite NoiseGenerator::GetNoise()
+void VoxelRenderer::BufferVoxelMesh(const ChunkID& chunk_id, VoxelMesh& mesh)
 {
-    return m_noise;
-}
\ No newline at end of file
+    // The chunk was evicted while its mesh was in flight
+    if (!VB::inst().GetMultiChunkSystem()->HasChunk(chunk_id)) return;
+
+    if (VoxelRendererVAO == 0) create_mesh_arenas();
+
+    // Sections the mesh doesn't hold keep their ranges and contents, remeshed sections (e.g. after an edit or
+    //   a neighbour arrived) keep their ranges when the new data still fits
+    VoxelRenderBufferInfo& VRBI = VoxelRendererBufferInfoMap[chunk_id];
+    VRBI.chunk_id = chunk_id;
+    VRBI.chunk_origin = VB::inst().GetMultiChunkSystem()->GetChunkOrigin(chunk_id);
+    VRBI.connectivity = mesh.connectivity;
+    const uint64_t* revision = m_mesh_revisions.Find(chunk_id);
+    VRBI.revision = revision ? *revision : 0;
+
+    for (int s = 0; s < MESH_SECTIONS; s++)
+    {
+        if (!(mesh.section_mask & (1 << s))) continue;
+
+        const VoxelMesh::Section& mesh_section = mesh.sections[s];
+        VoxelRenderBufferInfo::Section& section = VRBI.sections[s];
+        section.vtx_size = mesh_section.vertices.size();
+        section.idx_size = mesh_section.indices.size();
+        section.vtx_offset = arena_reallocate(m_vertex_arena, section.vtx_offset, section.vtx_size, chunk_id);
+        section.idx_offset = arena_reallocate(m_index_arena, section.idx_offset, section.idx_size, chunk_id);
+        section.bounds.min = glm::vec3(VRBI.chunk_origin + mesh_section.bounds_min);
+        section.bounds.max = glm::vec3(VRBI.chunk_origin + mesh_section.bounds_max);
+
+        if (section.vtx_size > 0)
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_vertex_arena.buffer);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, section.vtx_offset * sizeof(uint32_t), section.vtx_size * sizeof(uint32_t), mesh_section.vertices.data());
+            assign_page_origins(section.vtx_offset, VRBI.chunk_origin);
+        }
+
+        if (section.idx_size > 0)
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_index_arena.buffer);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, section.idx_offset * sizeof(unsigned int), section.idx_size * sizeof(unsigned int), mesh_section.indices.data());
+        }
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    VRBI.idx_size = 0;
+    VRBI.bounds = AABB();
+    for (const VoxelRenderBufferInfo::Section& section : VRBI.sections)
+    {
+        if (section.idx_size == 0) continue;
+        VRBI.bounds.min = VRBI.idx_size == 0 ? section.bounds.min : glm::min(VRBI.bounds.min, section.bounds.min);
+        VRBI.bounds.max = VRBI.idx_size == 0 ? section.bounds.max : glm::max(VRBI.bounds.max, section.bounds.max);
+        VRBI.idx_size += section.idx_size;
+    }
+}
+
+void VoxelRenderer::DeleteVoxelMesh(const ChunkID& chunk_id)
+{
+    m_mesh_revisions.Erase(chunk_id);
+    const VoxelRenderBufferInfo* info = VoxelRendererBufferInfoMap.Find(chunk_id);
+    if (!info) return;
+
+    for (const VoxelRenderBufferInfo::Section& section : info->sections)
+    {
+        arena_free(m_vertex_arena, section.vtx_offset);
+        arena_free(m_index_arena, section.idx_offset);
+    }
+
+    VoxelRendererBufferInfoMap.Erase(chunk_id);
+}
+
+void VoxelRenderer::RenderMesh(const ChunkID& chunk_id)
+{
+    const VoxelRenderBufferInfo* info = VoxelRendererBufferInfoMap.Find(chunk_id);
+    if (!info) return;
+    VoxelRenderBufferInfo CurrentMeshBufferInfo = *info;
+
+    bind_render_state();
+    for (const VoxelRenderBufferInfo::Section& section : CurrentMeshBufferInfo.sections)
+    {
+        if (section.idx_size == 0) continue;
+        glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(section.idx_size), GL_UNSIGNED_INT,
+                                 reinterpret_cast<const void*>(section.idx_offset * sizeof(unsigned int)),
+                                 static_cast<GLint>(section.vtx_offset));
+    }
+    glBindVertexArray(0);
+}
+
+void VoxelRenderer::RenderAllMeshes(const glm::mat4& view_projection)
+{
+    m_render_stats = RenderStats();
+    if (m_voxel_shader == nullptr || VoxelRendererVAO == 0) return;
+
+    m_frustum.Update(view_projection);
+
+    bool occlusion = m_occlusion_culling && run_occlusion_culling();
+
+    m_draw_counts.clear();
+    m_draw_offsets.clear();
+    m_draw_base_vertices.clear();
+
+    for (const auto& render_item : VoxelRendererBufferInfoMap)
+    {
+        const VoxelRenderBufferInfo& info = render_item.second;
+        if (info.idx_size == 0) continue;
+        if (!m_frustum.IsBoxVisible(info.bounds))
+        {
+            m_render_stats.culled++;
+            continue;
+        }
+        if (occlusion && !m_occlusion_culler.IsVisible(render_item.first))
+        {
+            m_render_stats.occluded++;
+            continue;
+        }
+
+        // The chunk is partly in view, each section gets its own test
+        for (const VoxelRenderBufferInfo::Section& section : info.sections)
+        {
+            if (section.idx_size == 0) continue;
+            if (!m_frustum.IsBoxVisible(section.bounds))
+            {
+                m_render_stats.sections_culled++;
+                continue;
+            }
+
+            m_draw_counts.push_back(static_cast<GLsizei>(section.idx_size));
+            m_draw_offsets.push_back(reinterpret_cast<const void*>(section.idx_offset * sizeof(unsigned int)));
+            m_draw_base_vertices.push_back(static_cast<GLint>(section.vtx_offset));
+        }
+    }
+
+    m_render_stats.drawn = m_draw_counts.size();
+    if (m_draw_counts.empty()) return;
+
+    bind_render_state();
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, m_draw_counts.data(), GL_UNSIGNED_INT, m_draw_offsets.data(),
+                                  static_cast<GLsizei>(m_draw_counts.size()), m_draw_base_vertices.data());
+    glBindVertexArray(0);
+    m_render_stats.draw_calls = 1;
+}
+
+const VoxelRenderer::RenderStats& VoxelRenderer::GetRenderStats() const
+{
+    return m_render_stats;
+}
+
+void VoxelRenderer::SetOcclusionCulling(bool enabled)
+{
+    m_occlusion_culling = enabled;
+}
+
+bool VoxelRenderer::GetOcclusionCulling() const
+{
+    return m_occlusion_culling;
+}
+
+bool VoxelRenderer::run_occlusion_culling()
+{
+    auto start_time = std::chrono::steady_clock::now();
+    std::shared_ptr<MultiChunkSystem> chunk_system = VB::inst().GetMultiChunkSystem();
+
+    // Chunks still waiting for their first mesh are treated as open so they can't hide anything behind them
+    auto lookup = [&](const glm::ivec3& chunk_idx, OcclusionCuller::Node& node)
+    {
+        ChunkID chunk_id;
+        if (!chunk_system->FindChunk(chunk_idx, chunk_id)) return false;
+
+        glm::vec3 origin = glm::vec3(chunk_idx * Chunk::CHUNK_SIZE);
+        node.id = chunk_id;
+        node.bounds.min = origin;
+        node.bounds.max = origin + glm::vec3(static_cast<float>(Chunk::CHUNK_SIZE));
+
+        const VoxelRenderBufferInfo* info = VoxelRendererBufferInfoMap.Find(chunk_id);
+        node.connectivity = info ? info->connectivity : FACES_ALL_CONNECTED;
+        return true;
+    };
+
+    // Outside the loaded layers the walk starts from the nearest layer, entering through the face towards the camera
+    glm::ivec3 camera_idx = glm::ivec3(glm::floor(VB::inst().GetCamera()->Position / static_cast<float>(Chunk::CHUNK_SIZE)));
+    glm::ivec3 start_idx = camera_idx;
+    int entry_face = -1;
+    int min_layer = 0, max_layer = 0;
+    chunk_system->GetLayerRange(min_layer, max_layer);
+    if (camera_idx.y > max_layer)
+    {
+        start_idx.y = max_layer;
+        entry_face = FACE_POS_Y;
+    }
+    else if (camera_idx.y < min_layer)
+    {
+        start_idx.y = min_layer;
+        entry_face = FACE_NEG_Y;
+    }
+
+    m_occlusion_culler.Run(start_idx, entry_face, m_frustum, lookup);
+
+    m_render_stats.occlusion_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+    // Nothing to start from (e.g. the camera's chunk isn't loaded yet), fall back to frustum culling only
+    return m_occlusion_culler.GetVisibleCount() > 0;
+}
+
+void VoxelRenderer::FreeRenderMeshes()
+{
+    VoxelRendererBufferInfoMap.Clear();
+
+    glDeleteBuffers(1, &m_vertex_arena.buffer);
+    glDeleteBuffers(1, &m_index_arena.buffer);
+    glDeleteBuffers(1, &m_page_origin_buffer);
+    glDeleteTextures(1, &m_page_origin_texture);
+    glDeleteVertexArrays(1, &VoxelRendererVAO);
+    glDeleteTextures(1, &m_palette_texture);
+
+    m_vertex_arena = MeshArena();
+    m_index_arena = MeshArena();
+    m_page_origins.clear();
+    m_page_origin_buffer = 0;
+    m_page_origin_texture = 0;
+    VoxelRendererVAO = 0;
+    m_palette_texture = 0;
+}
+
+ChunkNeighbours VoxelRenderer::mesh_neighbours(const ChunkID& chunk_id, int lod) const
+{
+    std::shared_ptr<MultiChunkSystem> chunk_system = VB::inst().GetMultiChunkSystem();
+    ChunkNeighbours neighbours = chunk_system->GetNeighbours(chunk_id);
+
+    // Seams between LOD rings: a neighbour meshed at a different resolution doesn't line up with this
+    //   chunk's border, so it counts as air and both sides keep their border faces. That closes any gaps
+    //   at the cost of a few hidden quads along the ring edges.
+    for (const Chunk*& neighbour : neighbours)
+        if (neighbour && chunk_system->GetChunkLOD(neighbour->GetChunkID()) != lod) neighbour = nullptr;
+
+    return neighbours;
+}
+
+void VoxelRenderer::create_palette_texture()
+{
+    float colors[256 * 3];
+    for (int i = 0; i < 256; i++)
+    {
+        const glm::vec3& color = GetVoxelData(static_cast<uint8_t>(i)).color;
+        colors[i * 3 + 0] = color.x;
+        colors[i * 3 + 1] = color.y;
+        colors[i * 3 + 2] = color.z;
+    }
+
+    glGenTextures(1, &m_palette_texture);
+    glBindTexture(GL_TEXTURE_1D, m_palette_texture);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_RGB32F, 256, 0, GL_RGB, GL_FLOAT, colors);
+    glBindTexture(GL_TEXTURE_1D, 0);
+}
+
+void VoxelRenderer::bind_render_state()
+{
+    //m_voxel_shader->use();
+
+    if (m_palette_texture == 0) create_palette_texture();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_1D, m_palette_texture);
+    m_voxel_shader->setInt("voxel_palette", 0);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, m_page_origin_texture);
+    m_voxel_shader->setInt("chunk_origins", 1);
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindVertexArray(VoxelRendererVAO);
+}
+
+void VoxelRenderer::create_mesh_arenas()
+{
+    // Roughly 4 MiB of vertices and 6 MiB of indices to start with, both grow on demand
+    create_arena(m_vertex_arena, GL_ARRAY_BUFFER, sizeof(uint32_t), 1024 * 1024, MESH_PAGE_VERTICES);
+    create_arena(m_index_arena, GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int), 1536 * 1024, 1);
+
+    m_page_origins.assign(m_vertex_arena.allocator.GetCapacity() / MESH_PAGE_VERTICES, glm::ivec4(0));
+    glGenBuffers(1, &m_page_origin_buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, m_page_origin_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, m_page_origins.size() * sizeof(glm::ivec4), m_page_origins.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glGenTextures(1, &m_page_origin_texture);
+    glBindTexture(GL_TEXTURE_BUFFER, m_page_origin_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32I, m_page_origin_buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    // The VAO never changes apart from pointing at a new buffer when an arena grows
+    glGenVertexArrays(1, &VoxelRendererVAO);
+    glBindVertexArray(VoxelRendererVAO);
+
+    // packed vertex attribute, unpacked in voxel_vert.glsl
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_arena.buffer);
+    glEnableVertexAttribArray(0);
+    glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*)0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_index_arena.buffer);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void VoxelRenderer::create_arena(MeshArena& arena, GLenum target, size_t element_size, size_t capacity, size_t alignment)
+{
+    arena.target = target;
+    arena.element_size = element_size;
+    arena.allocator = GpuAllocator(capacity, alignment);
+
+    glGenBuffers(1, &arena.buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, arena.buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, arena.allocator.GetCapacity() * element_size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+size_t VoxelRenderer::arena_reallocate(MeshArena& arena, size_t offset, size_t count, ChunkID owner)
+{
+    if (offset != GpuAllocator::INVALID_OFFSET)
+    {
+        if (count > 0 && arena.allocator.Resize(offset, count))
+        {
+            m_reused_in_place++;
+            return offset;
+        }
+        arena.allocator.Free(offset);
+    }
+
+    if (count == 0) return GpuAllocator::INVALID_OFFSET;
+
+    size_t new_offset = arena.allocator.Allocate(count, owner);
+    if (new_offset == GpuAllocator::INVALID_OFFSET)
+    {
+        // The space added at the end is always large enough
+        arena_grow(arena, arena.allocator.GetCapacity() + count);
+        new_offset = arena.allocator.Allocate(count, owner);
+    }
+
+    return new_offset;
+}
+
+void VoxelRenderer::arena_free(MeshArena& arena, size_t offset)
+{
+    if (offset != GpuAllocator::INVALID_OFFSET) arena.allocator.Free(offset);
+}
+
+void VoxelRenderer::arena_grow(MeshArena& arena, size_t min_capacity)
+{
+    size_t old_capacity = arena.allocator.GetCapacity();
+    size_t alignment = arena.allocator.GetAlignment();
+    size_t new_capacity = (std::max(old_capacity * 2, min_capacity) + alignment - 1) / alignment * alignment;
+
+    GLuint new_buffer;
+    glGenBuffers(1, &new_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, new_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, new_capacity * arena.element_size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, arena.buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, old_capacity * arena.element_size);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &arena.buffer);
+
+    arena.buffer = new_buffer;
+    arena.allocator.Grow(new_capacity);
+
+    VB::inst().GetLogger()->Print("Mesh arena grown to " + std::to_string(new_capacity * arena.element_size / (1024 * 1024)) + " MiB");
+
+    glBindVertexArray(VoxelRendererVAO);
+    if (arena.target == GL_ARRAY_BUFFER)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, arena.buffer);
+        glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*)0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_page_origins.resize(new_capacity / MESH_PAGE_VERTICES, glm::ivec4(0));
+        glBindBuffer(GL_TEXTURE_BUFFER, m_page_origin_buffer);
+        glBufferData(GL_TEXTURE_BUFFER, m_page_origins.size() * sizeof(glm::ivec4), m_page_origins.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+        glBindTexture(GL_TEXTURE_BUFFER, m_page_origin_texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32I, m_page_origin_buffer);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+    else
+    {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arena.buffer);
+    }
+    glBindVertexArray(0);
+}
+
+void VoxelRenderer::compact_arena(MeshArena& arena, size_t max_bytes)
+{
+    if (arena.allocator.GetStats().fragmentation < COMPACTION_THRESHOLD) return;
+
+    size_t moved_bytes = 0;
+    GpuAllocator::Move move;
+    while (moved_bytes < max_bytes && arena.allocator.NextCompactionMove(move))
+    {
+        // Allocations are owned by chunks. One whose chunk has no mesh anymore is drawn by nothing, so it is
+        //   freed rather than moved, which would otherwise offer the same move again on every step.
+        VoxelRenderBufferInfo* owner_info = VoxelRendererBufferInfoMap.Find(move.owner);
+        if (!owner_info)
+        {
+            VB::inst().GetLogger()->PrintErr("Mesh arena range at " + std::to_string(move.from) + " has no owning chunk, freeing it");
+            arena.allocator.Free(move.from);
+            continue;
+        }
+
+        // Source and destination never overlap since the destination is a free range
+        glBindBuffer(GL_COPY_READ_BUFFER, arena.buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, arena.buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                            move.from * arena.element_size, move.to * arena.element_size, move.size * arena.element_size);
+        arena.allocator.ApplyMove(move);
+
+        // The section is the one whose range just moved
+        VoxelRenderBufferInfo& info = *owner_info;
+        for (VoxelRenderBufferInfo::Section& section : info.sections)
+        {
+            if (arena.target == GL_ARRAY_BUFFER && section.vtx_offset == move.from)
+            {
+                section.vtx_offset = move.to;
+                assign_page_origins(section.vtx_offset, info.chunk_origin);
+                break;
+            }
+            if (arena.target != GL_ARRAY_BUFFER && section.idx_offset == move.from)
+            {
+                section.idx_offset = move.to;
+                break;
+            }
+        }
+
+        moved_bytes += move.size * arena.element_size;
+        m_compaction_moves++;
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void VoxelRenderer::assign_page_origins(size_t vtx_offset, const glm::ivec3& origin)
+{
+    size_t first_page = vtx_offset / MESH_PAGE_VERTICES;
+    size_t page_count = m_vertex_arena.allocator.GetAllocationSize(vtx_offset) / MESH_PAGE_VERTICES;
+    for (size_t page = first_page; page < first_page + page_count; page++)
+        m_page_origins[page] = glm::ivec4(origin, 0);
+
+    upload_page_origins(first_page, page_count);
+}
+
+void VoxelRenderer::upload_page_origins(size_t first_page, size_t page_count)
+{
+    glBindBuffer(GL_TEXTURE_BUFFER, m_page_origin_buffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, first_page * sizeof(glm::ivec4), page_count * sizeof(glm::ivec4), &m_page_origins[first_page]);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+// ----------<[ CHUNK CLASS IMPLEMENTATION ]>----------
+Chunk::Chunk(ChunkID chunk_id, glm::ivec3 origin)
+{
+    m_chunkID = chunk_id;
+    m_origin = origin;
+
+    VB::inst().GetLogger()->Print("Chunk obj with ID: " + std::to_string(chunk_id) + " constructed");
+}
+
+glm::ivec3 Chunk::getOrigin()
+{
+    return m_origin;
+}
+
+ChunkID Chunk::GetChunkID() const
+{
+    return m_chunkID;
+}
+
+void Chunk::SetVoxel(glm::ivec3 pos, const uint8_t& id)
+{
+    if (glm::any(glm::lessThan(pos, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(pos, glm::ivec3(CHUNK_SIZE))))
+        throw std::out_of_range("Chunk::SetVoxel position out of range");
+
+    SetVoxelUnchecked(pos, id);
+}
+
+uint8_t Chunk::GetVoxel(glm::ivec3 pos) const
+{
+    if (glm::any(glm::lessThan(pos, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(pos, glm::ivec3(CHUNK_SIZE))))
+        throw std::out_of_range("Chunk::GetVoxel position out of range");
+
+    return GetVoxelUnchecked(pos);
+}
+
+uint8_t Chunk::GetVoxelUnchecked(glm::ivec3 pos) const
+{
+    if (m_sections.empty()) return m_uniform_id;
+
+    glm::ivec3 section = pos / SECTION_SIZE;
+    glm::ivec3 local = pos % SECTION_SIZE;
+    return m_sections[section.x * SECTIONS_PER_AXIS * SECTIONS_PER_AXIS + section.y * SECTIONS_PER_AXIS + section.z]
+        .GetUnchecked(local.x * SECTION_SIZE * SECTION_SIZE + local.y * SECTION_SIZE + local.z);
+}
+
+void Chunk::SetVoxelUnchecked(glm::ivec3 pos, uint8_t id)
+{
+    m_dirty = true;
+    if (m_sections.empty())
+    {
+        if (id == m_uniform_id) return;
+        m_sections.assign(SECTIONS_PER_AXIS * SECTIONS_PER_AXIS * SECTIONS_PER_AXIS, PaletteStorage(SECTION_SIZE * SECTION_SIZE * SECTION_SIZE, m_uniform_id));
+    }
+
+    glm::ivec3 section = pos / SECTION_SIZE;
+    glm::ivec3 local = pos % SECTION_SIZE;
+    m_sections[section.x * SECTIONS_PER_AXIS * SECTIONS_PER_AXIS + section.y * SECTIONS_PER_AXIS + section.z]
+        .Set(local.x * SECTION_SIZE * SECTION_SIZE + local.y * SECTION_SIZE + local.z, id);
+}
+
+void Chunk::CopyRegion(glm::ivec3 min, glm::ivec3 max, uint8_t* out, size_t stride_x, size_t stride_y) const
+{
+    if (glm::any(glm::lessThan(min, glm::ivec3(0))) || glm::any(glm::greaterThan(max, glm::ivec3(CHUNK_SIZE))))
+        throw std::out_of_range("Chunk::CopyRegion box out of range");
+    if (glm::any(glm::greaterThanEqual(min, max))) return;
+
+    // Walks the sections the box overlaps so uniform ones are filled without touching their storage
+    glm::ivec3 first_section = min / SECTION_SIZE;
+    glm::ivec3 last_section = (max - 1) / SECTION_SIZE;
+    for (int sx = first_section.x; sx <= last_section.x; sx++)
+    for (int sy = first_section.y; sy <= last_section.y; sy++)
+    for (int sz = first_section.z; sz <= last_section.z; sz++)
+    {
+        glm::ivec3 section(sx, sy, sz);
+        glm::ivec3 box_min = glm::max(min, section * SECTION_SIZE);
+        glm::ivec3 box_max = glm::min(max, (section + 1) * SECTION_SIZE);
+
+        uint8_t uniform_id;
+        const PaletteStorage* storage = nullptr;
+        if (!IsSectionUniform(section, uniform_id))
+            storage = &m_sections[sx * SECTIONS_PER_AXIS * SECTIONS_PER_AXIS + sy * SECTIONS_PER_AXIS + sz];
+
+        for (int x = box_min.x; x < box_max.x; x++)
+        {
+            for (int y = box_min.y; y < box_max.y; y++)
+            {
+                uint8_t* row = out + (x - min.x) * stride_x + (y - min.y) * stride_y - min.z;
+                if (storage == nullptr)
+                {
+                    std::fill(row + box_min.z, row + box_max.z, uniform_id);
+                    continue;
+                }
+
+                size_t base = (x % SECTION_SIZE) * SECTION_SIZE * SECTION_SIZE + (y % SECTION_SIZE) * SECTION_SIZE;
+                for (int z = box_min.z; z < box_max.z; z++)
+                    row[z] = storage->GetUnchecked(base + z % SECTION_SIZE);
+            }
+        }
+    }
+}
+
+void Chunk::SetVoxels(const uint8_t* in)
+{
+    const int chunk_volume = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+    const int section_volume = SECTION_SIZE * SECTION_SIZE * SECTION_SIZE;
+    m_dirty = true;
+
+    if (std::all_of(in, in + chunk_volume, [&](uint8_t id) { return id == in[0]; }))
+    {
+        Fill(in[0]);
+        return;
+    }
+
+    std::vector<PaletteStorage> sections;
+    sections.reserve(SECTIONS_PER_AXIS * SECTIONS_PER_AXIS * SECTIONS_PER_AXIS);
+
+    uint8_t section_ids[section_volume];
+    for (int sx = 0; sx < SECTIONS_PER_AXIS; sx++)
+    for (int sy = 0; sy < SECTIONS_PER_AXIS; sy++)
+    for (int sz = 0; sz < SECTIONS_PER_AXIS; sz++)
+    {
+        for (int x = 0; x < SECTION_SIZE; x++)
+            for (int y = 0; y < SECTION_SIZE; y++)
+                std::copy_n(in + (sx * SECTION_SIZE + x) * CHUNK_SIZE * CHUNK_SIZE + (sy * SECTION_SIZE + y) * CHUNK_SIZE + sz * SECTION_SIZE,
+                            SECTION_SIZE, section_ids + x * SECTION_SIZE * SECTION_SIZE + y * SECTION_SIZE);
+
+        sections.emplace_back(section_volume);
+        sections.back().Encode(section_ids);
+    }
+
+    m_sections.swap(sections);
+}
+
+void Chunk::Fill(uint8_t id)
+{
+    m_dirty = true;
+    m_uniform_id = id;
+    std::vector<PaletteStorage>().swap(m_sections);
+}
+
+size_t Chunk::GetMemoryUsage() const
+{
+    size_t total = sizeof(Chunk);
+    for (const PaletteStorage& section : m_sections) total += section.GetMemoryUsage();
+    return total;
+}
+
+uint64_t Chunk::GetContentHash() const
+{
+    const int section_volume = SECTION_SIZE * SECTION_SIZE * SECTION_SIZE;
+
+    // FNV-1a over 8 ids at a time, section by section in CopySection order
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    uint8_t section_ids[section_volume];
+    for (int sx = 0; sx < SECTIONS_PER_AXIS; sx++)
+    for (int sy = 0; sy < SECTIONS_PER_AXIS; sy++)
+    for (int sz = 0; sz < SECTIONS_PER_AXIS; sz++)
+    {
+        CopySection(glm::ivec3(sx, sy, sz), section_ids);
+        for (int i = 0; i < section_volume; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, section_ids + i, sizeof(word));
+            hash = (hash ^ word) * 0x100000001b3ULL;
+        }
+    }
+
+    return hash ^ (hash >> 32);
+}
+
+void Chunk::Serialize(std::vector<uint8_t>& out, uint8_t format) const
+{
+    out.push_back(format);
+    if (format != CHUNK_FORMAT_SECTIONS)
+    {
+        ChunkCodec::Encode(*this, out, format == CHUNK_FORMAT_RUNS_LZ);
+        return;
+    }
+
+    if (m_sections.empty())
+    {
+        out.push_back(1);
+        out.push_back(m_uniform_id);
+        return;
+    }
+
+    out.push_back(0);
+    for (const PaletteStorage& section : m_sections) section.Serialize(out);
+}
+
+bool Chunk::Deserialize(const uint8_t* data, size_t size)
+{
+    const uint8_t* end = data + size;
+    if (size < 1) return false;
+
+    if (data[0] == CHUNK_FORMAT_RUNS || data[0] == CHUNK_FORMAT_RUNS_LZ)
+    {
+        if (!ChunkCodec::Decode(data + 1, size - 1, data[0] == CHUNK_FORMAT_RUNS_LZ, *this)) return false;
+    }
+    else if (data[0] == CHUNK_FORMAT_SECTIONS && size >= 3 && data[1] == 1)
+    {
+        m_uniform_id = data[2];
+        std::vector<PaletteStorage>().swap(m_sections);
+    }
+    else if (data[0] == CHUNK_FORMAT_SECTIONS && size >= 3 && data[1] == 0)
+    {
+        const int section_volume = SECTION_SIZE * SECTION_SIZE * SECTION_SIZE;
+        std::vector<PaletteStorage> sections(SECTIONS_PER_AXIS * SECTIONS_PER_AXIS * SECTIONS_PER_AXIS, PaletteStorage(section_volume));
+
+        data += 2;
+        for (PaletteStorage& section : sections)
+            if (!section.Deserialize(data, end)) return false;
+
+        m_sections.swap(sections);
+    }
+    else
+    {
+        return false;
+    }
+
+    m_generated = true;
+    m_dirty = false;
+    return true;
+}
+
+bool Chunk::IsDirty() const
+{
+    return m_dirty;
+}
+
+void Chunk::ClearDirty()
+{
+    m_dirty = false;
+}
+
+bool Chunk::IsUniform() const
+{
+    return m_sections.empty();
+}
+
+bool Chunk::IsSectionUniform(glm::ivec3 section, uint8_t& id) const
+{
+    if (m_sections.empty())
+    {
+        id = m_uniform_id;
+        return true;
+    }
+
+    const PaletteStorage& storage = m_sections[section.x * SECTIONS_PER_AXIS * SECTIONS_PER_AXIS + section.y * SECTIONS_PER_AXIS + section.z];
+    if (!storage.IsUniform()) return false;
+
+    id = storage.Get(0);
+    return true;
+}
+
+void Chunk::CopySection(glm::ivec3 section, uint8_t* out) const
+{
+    const int section_volume = SECTION_SIZE * SECTION_SIZE * SECTION_SIZE;
+
+    if (m_sections.empty())
+    {
+        std::fill(out, out + section_volume, m_uniform_id);
+        return;
+    }
+
+    m_sections[section.x * SECTIONS_PER_AXIS * SECTIONS_PER_AXIS + section.y * SECTIONS_PER_AXIS + section.z].Decode(out);
+}
+
+void Chunk::SetSection(glm::ivec3 section, const uint8_t* in)
+{
+    const int section_volume = SECTION_SIZE * SECTION_SIZE * SECTION_SIZE;
+    m_dirty = true;
+
+    if (m_sections.empty())
+    {
+        if (std::all_of(in, in + section_volume, [&](uint8_t id) { return id == m_uniform_id; })) return;
+        m_sections.assign(SECTIONS_PER_AXIS * SECTIONS_PER_AXIS * SECTIONS_PER_AXIS, PaletteStorage(section_volume, m_uniform_id));
+    }
+
+    m_sections[section.x * SECTIONS_PER_AXIS * SECTIONS_PER_AXIS + section.y * SECTIONS_PER_AXIS + section.z].Encode(in);
+}
+
+void Chunk::Optimize()
+{
+    if (m_sections.empty()) return;
+
+    bool all_uniform = true;
+    for (PaletteStorage& section : m_sections)
+    {
+        section.Optimize();
+        if (!section.IsUniform() || section.Get(0) != m_sections[0].Get(0)) all_uniform = false;
+    }
+
+    if (all_uniform)
+    {
+        m_uniform_id = m_sections[0].Get(0);
+        std::vector<PaletteStorage>().swap(m_sections);
+    }
+}
+
+void Chunk::GenerateChunk()
+{
+    if (m_generated == true) return;
+    m_generated = true;
+
+    VB::inst().GetTerrainGenerator()->GenerateChunk(*this);
+    Optimize();
+
+    // Not on disk yet, even if it came out all air
+    m_dirty = true;
+}
+
+// ----------<[ MULTICHUNK CLASS IMPLEMENTATION ]>----------
+MultiChunkSystem::MultiChunkSystem()
+{
+    VB::inst().GetLogger()->Print("MultiChunk obj constructed");
+}
+
+void MultiChunkSystem::update()
+{
+    // get nearest chunk indices in range
+    glm::ivec3 nearest_chunk_idx;
+    nearest_chunk_idx = pos_to_nearest_chunk_idx(VB::inst().GetCamera()->Position);
+    m_center_idx = nearest_chunk_idx;
+
+    collect_generated_chunks(nearest_chunk_idx);
+    evict_far_chunks(nearest_chunk_idx);
+    update_chunk_lods(nearest_chunk_idx);
+
+    // Only keep a few jobs in flight so the queue can be re-prioritised as the camera moves
+    size_t max_pending_chunks = static_cast<size_t>(VB::inst().GetThreadPool()->GetThreadCount()) * 2;
+    if (m_pending_chunks.Size() >= max_pending_chunks) return;
+
+    glm::vec2 view_dir(VB::inst().GetCamera()->Front.x, VB::inst().GetCamera()->Front.z);
+    if (glm::length(view_dir) > 0.0f) view_dir = glm::normalize(view_dir);
+
+    int min_layer, max_layer;
+    layer_range(nearest_chunk_idx, m_vertical_radius, min_layer, max_layer);
+
+    std::vector<std::pair<float, glm::ivec3>> candidates;
+    
+    for (int x = -m_chunk_gen_radius; x < m_chunk_gen_radius; x++)
+    {
+        for (int z = -m_chunk_gen_radius; z < m_chunk_gen_radius; z++)
+        {
+            float chunk_dist = glm::length(glm::vec2(x, z));
+            if (chunk_dist > static_cast<float>(m_chunk_gen_radius)) continue;
+
+            for (int y = min_layer; y <= max_layer; y++)
+            {
+                glm::ivec3 pawsible_chunk_idx(  nearest_chunk_idx.x + x,
+                                                y,
+                                                nearest_chunk_idx.z + z);
+
+                if (!IsInWorld(pawsible_chunk_idx)) continue;
+
+                ChunkID curr_id = PackChunkID(pawsible_chunk_idx);
+                if (m_chunk_list.Contains(curr_id)) continue;
+                if (m_pending_chunks.Contains(curr_id)) continue;
+
+                // Nearest first, with chunks outside the view direction pushed back by half the radius
+                //   and layers away from the camera's pushed back a little per layer
+                float priority = chunk_dist + static_cast<float>(std::abs(y - nearest_chunk_idx.y)) * 0.5f;
+                if (chunk_dist > 1.0f && glm::dot(glm::vec2(x, z) / chunk_dist, view_dir) < 0.5f)
+                    priority += static_cast<float>(m_chunk_gen_radius) * 0.5f;
+
+                candidates.push_back({ priority, pawsible_chunk_idx });
+            }
+        }
+    }
+
+    size_t queue_count = std::min(candidates.size(), max_pending_chunks - m_pending_chunks.Size());
+    std::partial_sort(candidates.begin(), candidates.begin() + queue_count, candidates.end(),
+        [](const std::pair<float, glm::ivec3>& a, const std::pair<float, glm::ivec3>& b) { return a.first < b.first; });
+
+    for (size_t i = 0; i < queue_count; i++)
+        queue_chunk(candidates[i].second);
+}
+
+std::vector<ChunkID> MultiChunkSystem::TakeChunksToMesh()
+{
+    std::vector<ChunkID> chunks_to_mesh;
+    for (const auto& queued : m_chunks_to_mesh)
+        if (HasChunk(queued.first)) chunks_to_mesh.push_back(queued.first);
+
+    m_chunks_to_mesh.Clear();
+    return chunks_to_mesh;
+}
+
+bool MultiChunkSystem::HasChunk(const ChunkID& chunk_id) const
+{
+    return m_chunk_list.Contains(chunk_id);
+}
+
+Chunk* MultiChunkSystem::GetChunk(const ChunkID& chunk_id) const
+{
+    const LoadedChunk* loaded = m_chunk_list.Find(chunk_id);
+    return loaded ? loaded->chunk : nullptr;
+}
+
+ChunkHandle MultiChunkSystem::GetChunkHandle(const ChunkID& chunk_id) const
+{
+    const LoadedChunk* loaded = m_chunk_list.Find(chunk_id);
+    return loaded ? loaded->handle : ChunkHandle();
+}
+
+Chunk* MultiChunkSystem::ResolveChunkHandle(const ChunkHandle& handle) const
+{
+    if (handle.index >= m_chunk_slots.size() || m_chunk_generations[handle.index] != handle.generation) return nullptr;
+    return m_chunk_slots[handle.index].get();
+}
+
+bool MultiChunkSystem::IsInWorld(const glm::ivec3& chunk_idx)
+{
+    return std::abs(chunk_idx.x) <= WORLD_CHUNK_RADIUS && std::abs(chunk_idx.z) <= WORLD_CHUNK_RADIUS &&
+           chunk_idx.y >= WORLD_MIN_LAYER && chunk_idx.y <= WORLD_MAX_LAYER;
+}
+
+bool MultiChunkSystem::FindChunk(const glm::ivec3& chunk_idx, ChunkID& chunk_id) const
+{
+    chunk_id = PackChunkID(chunk_idx);
+    return IsInWorld(chunk_idx) && HasChunk(chunk_id);
+}
+
+void MultiChunkSystem::GetLayerRange(int& min_layer, int& max_layer) const
+{
+    layer_range(m_center_idx, m_vertical_radius, min_layer, max_layer);
+}
+
+ChunkNeighbours MultiChunkSystem::GetNeighbours(const ChunkID& chunk_id) const
+{
+    // Neighbour keys are offsets of the packed key, no unpacking needed
+    static const ChunkID face_steps[3] = { CHUNK_ID_STEP_X, CHUNK_ID_STEP_Y, CHUNK_ID_STEP_Z };
+
+    ChunkNeighbours neighbours = {};
+    if (!HasChunk(chunk_id)) return neighbours;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        neighbours[axis * 2] = GetChunk(chunk_id + face_steps[axis]);
+        neighbours[axis * 2 + 1] = GetChunk(chunk_id - face_steps[axis]);
+    }
+
+    return neighbours;
+}
+
+ChunkNeighbourhood MultiChunkSystem::GetNeighbourhood(const ChunkID& chunk_id) const
+{
+    ChunkNeighbourhood neighbourhood = {};
+    if (!HasChunk(chunk_id)) return neighbourhood;
+
+    ChunkID corner = chunk_id - CHUNK_ID_STEP_X - CHUNK_ID_STEP_Y - CHUNK_ID_STEP_Z;
+    for (int x = 0; x < 3; x++)
+        for (int y = 0; y < 3; y++)
+            for (int z = 0; z < 3; z++)
+                neighbourhood[x * 9 + y * 3 + z] = GetChunk(corner + x * CHUNK_ID_STEP_X + y * CHUNK_ID_STEP_Y + z * CHUNK_ID_STEP_Z);
+
+    return neighbourhood;
+}
+
+void MultiChunkSystem::SetChunkGenRadius(int radius)
+{
+    m_chunk_gen_radius = radius;
+}
+
+int MultiChunkSystem::GetChunkGenRadius() const
+{
+    return m_chunk_gen_radius;
+}
+
+void MultiChunkSystem::SetVerticalRadius(int radius)
+{
+    m_vertical_radius = std::max(radius, 0);
+}
+
+int MultiChunkSystem::GetVerticalRadius() const
+{
+    return m_vertical_radius;
+}
+
+size_t MultiChunkSystem::GetTotalChunksLoaded() const
+{
+    return m_total_chunks_loaded;
+}
+
+void MultiChunkSystem::MarkVoxelEdited(const ChunkID& chunk_id, const glm::ivec3& local_pos)
+{
+    glm::ivec3 section = local_pos / Chunk::SECTION_SIZE;
+    glm::ivec3 in_section = local_pos % Chunk::SECTION_SIZE;
+    mark_section_edited(chunk_id, section);
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        glm::ivec3 offset(0);
+        if (in_section[axis] == 0) offset[axis] = -1;
+        else if (in_section[axis] == Chunk::SECTION_SIZE - 1) offset[axis] = 1;
+        else continue;
+
+        mark_section_edited(chunk_id, section + offset);
+    }
+}
+
+std::vector<EditedChunk> MultiChunkSystem::TakeEditedChunks()
+{
+    std::vector<EditedChunk> edited_chunks;
+    for (const auto& edited : m_edited_sections)
+    {
+        // update() may have evicted it since the edit
+        if (!HasChunk(edited.first)) continue;
+
+        // Queued for a full remesh (a neighbour arrived, or its LOD changed), so no section can be skipped
+        bool queued = m_chunks_to_mesh.Erase(edited.first);
+        edited_chunks.push_back({ edited.first, queued ? ~uint64_t(0) : edited.second });
+    }
+
+    m_edited_sections.Clear();
+    return edited_chunks;
+}
+
+void MultiChunkSystem::SaveAllChunks()
+{
+    // The chunks stay loaded, so the I/O thread gets copies to encode
+    for (const auto& loaded : m_chunk_list)
+    {
+        if (!loaded.second.chunk->IsDirty()) continue;
+        VB::inst().GetChunkIO()->QueueSave(std::make_unique<Chunk>(*loaded.second.chunk));
+        loaded.second.chunk->ClearDirty();
+    }
+}
+
+size_t MultiChunkSystem::GetVoxelMemoryUsage() const
+{
+    size_t total = 0;
+    for (const auto& id_chunk : m_chunk_list) total += id_chunk.second.chunk->GetMemoryUsage();
+    return total;
+}
+
+void MultiChunkSystem::queue_chunk(glm::ivec3 chunk_idx)
+{
+    ChunkID curr_id = PackChunkID(chunk_idx);
+    glm::ivec3 curr_origin = chunk_idx_to_origin(chunk_idx);
+    m_pending_chunks[curr_id] = true;
+
+    // Each job only writes to its own chunk, so the result doesn't depend on which worker runs it
+    VB::inst().GetThreadPool()->Submit([this, curr_id, curr_origin]()
+    {
+        // Chunks saved before come back from disk, everything else is generated
+        std::unique_ptr<Chunk> curr_chunk = std::make_unique<Chunk>(curr_id, curr_origin);
+        if (!VB::inst().GetChunkIO()->LoadChunk(*curr_chunk)) curr_chunk->GenerateChunk();
+
+        std::lock_guard<std::mutex> lock(m_generated_mutex);
+        m_generated_chunks.push_back(std::move(curr_chunk));
+    });
+
+    VB::inst().GetLogger()->Print("ChunkId: " + std::to_string(curr_id) + " X: " + std::to_string(chunk_idx.x) + " Y: " + std::to_string(chunk_idx.y) + " Z: " + std::to_string(chunk_idx.z));
+}
+
+void MultiChunkSystem::collect_generated_chunks(glm::ivec3 center_idx)
+{
+    std::vector<std::unique_ptr<Chunk>> generated_chunks;
+    {
+        std::lock_guard<std::mutex> lock(m_generated_mutex);
+        generated_chunks.swap(m_generated_chunks);
+    }
+
+    for (std::unique_ptr<Chunk>& chunk : generated_chunks)
+    {
+        ChunkID chunk_id = chunk->GetChunkID();
+        glm::ivec3 chunk_idx = UnpackChunkID(chunk_id);
+        m_pending_chunks.Erase(chunk_id);
+
+        // The camera may have moved on while this chunk was being generated
+        if (chunk_outside_radius(chunk_idx, center_idx, m_chunk_gen_radius + m_evict_hysteresis, m_vertical_radius + m_evict_hysteresis)) continue;
+
+        int lod = lod_for_chunk(chunk_idx, m_lod_center_valid ? m_lod_center : center_idx);
+        add_chunk(std::move(chunk));
+        m_chunk_list.Find(chunk_id)->lod = lod;
+        m_chunks_to_mesh[chunk_id] = true;
+        mark_neighbours_to_mesh(chunk_id);
+        m_total_chunks_loaded++;
+    }
+}
+
+void MultiChunkSystem::evict_far_chunks(glm::ivec3 center_idx)
+{
+    std::vector<ChunkID> evicted_chunks;
+
+    for (const auto& loaded : m_chunk_list)
+        if (chunk_outside_radius(UnpackChunkID(loaded.first), center_idx, m_chunk_gen_radius + m_evict_hysteresis, m_vertical_radius + m_evict_hysteresis))
+            evicted_chunks.push_back(loaded.first);
+
+    // Erasing moves entries around the table, so it can't happen during the scan above
+    for (const ChunkID& chunk_id : evicted_chunks)
+    {
+        VB::inst().GetVoxel()->DeleteVoxelMesh(chunk_id);
+
+        // The chunk goes to the I/O thread as it is, encoding it there rather than here
+        std::unique_ptr<Chunk> chunk = remove_chunk(chunk_id);
+        if (chunk->IsDirty()) VB::inst().GetChunkIO()->QueueSave(std::move(chunk));
+    }
+
+    // Neighbours that stay loaded have to show the faces the evicted chunk used to hide
+    for (const ChunkID& chunk_id : evicted_chunks)
+    {
+        for (const ChunkID& step : { CHUNK_ID_STEP_X, CHUNK_ID_STEP_Y, CHUNK_ID_STEP_Z })
+        {
+            if (HasChunk(chunk_id + step)) m_chunks_to_mesh[chunk_id + step] = true;
+            if (HasChunk(chunk_id - step)) m_chunks_to_mesh[chunk_id - step] = true;
+        }
+    }
+}
+
+ChunkHandle MultiChunkSystem::add_chunk(std::unique_ptr<Chunk> chunk)
+{
+    ChunkHandle handle;
+    if (!m_free_chunk_slots.empty())
+    {
+        handle.index = m_free_chunk_slots.back();
+        m_free_chunk_slots.pop_back();
+    }
+    else
+    {
+        handle.index = static_cast<uint32_t>(m_chunk_slots.size());
+        m_chunk_slots.emplace_back();
+        m_chunk_generations.push_back(0);
+    }
+    handle.generation = m_chunk_generations[handle.index];
+
+    LoadedChunk& loaded = m_chunk_list[chunk->GetChunkID()];
+    loaded.handle = handle;
+    loaded.chunk = chunk.get();
+    m_chunk_slots[handle.index] = std::move(chunk);
+    return handle;
+}
+
+std::unique_ptr<Chunk> MultiChunkSystem::remove_chunk(const ChunkID& chunk_id)
+{
+    const LoadedChunk* loaded = m_chunk_list.Find(chunk_id);
+    if (!loaded) return nullptr;
+
+    uint32_t index = loaded->handle.index;
+    std::unique_ptr<Chunk> chunk = std::move(m_chunk_slots[index]);
+    m_chunk_generations[index]++;
+    m_free_chunk_slots.push_back(index);
+    m_chunk_list.Erase(chunk_id);
+    return chunk;
+}
+
+void MultiChunkSystem::mark_section_edited(const ChunkID& chunk_id, glm::ivec3 section)
+{
+    glm::ivec3 chunk_idx = UnpackChunkID(chunk_id);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        if (section[axis] < 0) { section[axis] += Chunk::SECTIONS_PER_AXIS; chunk_idx[axis]--; }
+        else if (section[axis] >= Chunk::SECTIONS_PER_AXIS) { section[axis] -= Chunk::SECTIONS_PER_AXIS; chunk_idx[axis]++; }
+    }
+
+    ChunkID marked_id = PackChunkID(chunk_idx);
+    if (!HasChunk(marked_id)) return;
+
+    int bit = section.x * Chunk::SECTIONS_PER_AXIS * Chunk::SECTIONS_PER_AXIS + section.y * Chunk::SECTIONS_PER_AXIS + section.z;
+    m_edited_sections[marked_id] |= uint64_t(1) << bit;
+}
+
+void MultiChunkSystem::mark_neighbours_to_mesh(const ChunkID& chunk_id)
+{
+    for (const Chunk* neighbour : GetNeighbours(chunk_id))
+        if (neighbour) m_chunks_to_mesh[neighbour->GetChunkID()] = true;
+}
+
+int MultiChunkSystem::lod_for_chunk(glm::ivec3 chunk_idx, glm::ivec3 center_idx) const
+{
+    float chunk_dist = glm::distance(glm::vec3(center_idx), glm::vec3(chunk_idx));
+
+    int lod = 0;
+    float ring_radius = static_cast<float>(m_lod_radius);
+    while (lod < MAX_LOD && chunk_dist > ring_radius)
+    {
+        lod++;
+        ring_radius *= 2.0f;
+    }
+    return lod;
+}
+
+void MultiChunkSystem::update_chunk_lods(glm::ivec3 center_idx)
+{
+    if (m_lod_center_valid && m_lod_center == center_idx) return;
+    m_lod_center = center_idx;
+    m_lod_center_valid = true;
+
+    for (auto& chunk : m_chunk_list)
+    {
+        int lod = lod_for_chunk(UnpackChunkID(chunk.first), center_idx);
+        int& current_lod = chunk.second.lod;
+        if (current_lod == lod) continue;
+
+        // Neighbours are remeshed as well since the seam between them has moved
+        current_lod = lod;
+        m_chunks_to_mesh[chunk.first] = true;
+        mark_neighbours_to_mesh(chunk.first);
+    }
+}
+
+int MultiChunkSystem::GetChunkLOD(const ChunkID& chunk_id) const
+{
+    const LoadedChunk* loaded = m_chunk_list.Find(chunk_id);
+    return loaded ? loaded->lod : 0;
+}
+
+void MultiChunkSystem::SetLODRadius(int radius)
+{
+    radius = std::max(radius, 1);
+    if (radius == m_lod_radius) return;
+
+    m_lod_radius = radius;
+    // Forces every chunk's LOD to be reassigned on the next update
+    m_lod_center_valid = false;
+}
+
+int MultiChunkSystem::GetLODRadius() const
+{
+    return m_lod_radius;
+}
+
+std::array<size_t, MultiChunkSystem::MAX_LOD + 1> MultiChunkSystem::GetLODCounts() const
+{
+    std::array<size_t, MAX_LOD + 1> counts = { 0 };
+    for (const auto& loaded : m_chunk_list)
+        counts[loaded.second.lod]++;
+    return counts;
+}
+
+bool MultiChunkSystem::chunk_outside_radius(glm::ivec3 chunk_idx, glm::ivec3 center_idx, int radius, int vertical_radius)
+{
+    int min_layer, max_layer;
+    layer_range(center_idx, vertical_radius, min_layer, max_layer);
+    if (chunk_idx.y < min_layer || chunk_idx.y > max_layer) return true;
+
+    return glm::distance(glm::vec2(center_idx.x, center_idx.z), glm::vec2(chunk_idx.x, chunk_idx.z)) > static_cast<float>(radius);
+}
+
+void MultiChunkSystem::layer_range(glm::ivec3 center_idx, int vertical_radius, int& min_layer, int& max_layer) const
+{
+    // A camera above or below the world still streams in the layers nearest to it
+    int center_layer = std::clamp(center_idx.y, WORLD_MIN_LAYER, WORLD_MAX_LAYER);
+    min_layer = std::max(center_layer - vertical_radius, WORLD_MIN_LAYER);
+    max_layer = std::min(center_layer + vertical_radius, WORLD_MAX_LAYER);
+}
+
+glm::ivec3 MultiChunkSystem::pos_to_nearest_chunk_idx(glm::vec3 camera_position)
+{
+    return glm::ivec3(glm::floor(camera_position / static_cast<float>(Chunk::CHUNK_SIZE)));
+}
+
+const ChunkMap<MultiChunkSystem::LoadedChunk>& MultiChunkSystem::get_chunk_map() const
+{
+    return m_chunk_list;
+}
+
+glm::ivec3 MultiChunkSystem::chunk_idx_to_origin(glm::ivec3 chunk_idx)
+{
+    return chunk_idx * Chunk::CHUNK_SIZE;
+}
+
+const glm::ivec3 MultiChunkSystem::GetChunkOrigin(const ChunkID& chunk_id)
+{
+    Chunk* chunk = GetChunk(chunk_id);
+    if (chunk == nullptr) return glm::ivec3(0, 0, 0);
+    else return chunk->getOrigin();
+}
@@ -7,23 +7,42 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <deque>
+#include <algorithm>
+#include <stdexcept>
+#include <bit>
+#include <array>
+#include <chrono>
 #include "shader.h"
-#include "../include/FastNoiseLite/FastNoiseLite.h"
+#include "palette.h"
+#include "culling.h"
+#include "gpu_allocator.h"
+#include "chunk_map.h"
 
 class VoxelRenderer;
 class Chunk;
 class MultiChunkSystem;
 class NoiseGenerator;
 
-typedef unsigned long long int ChunkID;
+// Adjacent chunks in VoxelFace order (+X, -X, +Y, -Y, +Z, -Z), null where nothing is loaded
+typedef std::array<const Chunk*, 6> ChunkNeighbours;
+// The 3x3x3 block of chunks around (and including) a chunk, indexed (dx + 1) * 9 + (dy + 1) * 3 + (dz + 1)
+typedef std::array<const Chunk*, 27> ChunkNeighbourhood;
+
+// A chunk whose voxels were edited since it was last meshed
+struct EditedChunk
+{
+    ChunkID chunk_id;
+    // Bit section.x * 16 + section.y * 4 + section.z for each 16^3 section whose mesh is out of date
+    uint64_t sections;
+};
 
 class VoxelRenderer
 {
 public:
     VoxelRenderer();
 
-    uint8_t voxelId = 1;
-
     struct VoxelData {
         const char* name;
         glm::vec3 color;
@@ -36,32 +55,162 @@ public:
 
     static const VoxelData& GetVoxelData(uint8_t voxelId);
 
+    // Face directions stored in the packed vertex: +X, -X, +Y, -Y, +Z, -Z
+    enum VoxelFace : uint8_t
+    {
+        FACE_POS_X = 0,
+        FACE_NEG_X,
+        FACE_POS_Y,
+        FACE_NEG_Y,
+        FACE_POS_Z,
+        FACE_NEG_Z
+    };
+
+    // Chunk meshes are split into horizontal slabs one Chunk::SECTION_SIZE tall, each buffered and culled on
+    //   its own so an edit only rebuilds and re-uploads the slabs it touched
+    static const int MESH_SECTIONS = 4;
+    static const int MESH_SECTION_HEIGHT = 16;
+    static const uint8_t ALL_MESH_SECTIONS = (1 << MESH_SECTIONS) - 1;
+
     struct VoxelMesh
     {
-        std::vector<float> vertices;
-        std::vector<unsigned int> indices;
+        struct Section
+        {
+            // One 32-bit word per vertex: chunk-local x, y, z (7 bits each, 0..64), face (3 bits), voxel id (8 bits)
+            std::vector<uint32_t> vertices;
+            std::vector<unsigned int> indices;
 
-        int AddVertex(float x, float y, float z, uint8_t id);
-        void AddIndex(int v0, int v1, int v2);
+            // Chunk-local bounds of every vertex added so far, min > max while the section is empty
+            glm::ivec3 bounds_min = glm::ivec3(127);
+            glm::ivec3 bounds_max = glm::ivec3(0);
+        };
+        std::array<Section, MESH_SECTIONS> sections;
+        // Bit per section that was generated, the others are left empty and keep what's already buffered
+        uint8_t section_mask = ALL_MESH_SECTIONS;
+        // Which chunk faces can see each other through open voxels, used for occlusion culling
+        FaceConnectivity connectivity = FACES_ALL_CONNECTED;
+
+        int AddVertex(int section, int x, int y, int z, uint8_t face, uint8_t id);
+        void AddIndex(int section, int v0, int v1, int v2);
+        size_t GetByteSize() const;
+        // True if every section holds the same quads as other's, in any order
+        bool HasSameQuads(const VoxelMesh& other) const;
     };
 
     struct VoxelRenderBufferInfo
     {
-        GLuint VBO;
-        GLuint EBO;
-        ChunkID chunk_id;
-        size_t vtx_size;
-        size_t idx_size;
-        glm::ivec3 chunk_origin;
+        struct Section
+        {
+            // Offsets into the shared vertex / index arenas in elements, GpuAllocator::INVALID_OFFSET if empty
+            size_t vtx_offset = GpuAllocator::INVALID_OFFSET;
+            size_t idx_offset = GpuAllocator::INVALID_OFFSET;
+            size_t vtx_size = 0;
+            size_t idx_size = 0;
+            AABB bounds;
+        };
+
+        ChunkID chunk_id = 0;
+        glm::ivec3 chunk_origin = glm::ivec3(0);
+        std::array<Section, MESH_SECTIONS> sections;
+        // Indices across every section, and the union of the non-empty sections' bounds that is tested
+        //   before the sections themselves
+        size_t idx_size = 0;
+        AABB bounds;
+        FaceConnectivity connectivity = FACES_ALL_CONNECTED;
+        // Mesh revision this was last buffered from, anything newer is still in flight
+        uint64_t revision = 0;
+    };
+
+    struct MeshStats
+    {
+        size_t meshes = 0;
+        size_t sections = 0;
+        size_t quads = 0;
+        size_t vertices = 0;
+        size_t indices = 0;
+        size_t bytes = 0;
+        size_t arena_bytes = 0;
+    };
+
+    // Draw calls issued, sections drawn, and chunks / sections rejected by the frustum test during the last
+    //   RenderAllMeshes()
+    struct RenderStats
+    {
+        size_t draw_calls = 0;
+        size_t drawn = 0;
+        size_t culled = 0;
+        size_t sections_culled = 0;
+        size_t occluded = 0;
+        double occlusion_ms = 0.0;
     };
 
     void SetShader(std::shared_ptr<Shader> shader);
 
-    VoxelMesh GenerateChunkMesh(Chunk chunk);
+    // lod 0 meshes every voxel, lod l meshes 2^l blocks of voxels as one (down to 8^3 blocks at lod 3).
+    //   Only the mesh sections in the sections mask are generated.
+    VoxelMesh GenerateChunkMesh(const Chunk& chunk, const ChunkNeighbours& neighbours = ChunkNeighbours(), int lod = 0,
+                                uint8_t sections = ALL_MESH_SECTIONS) const;
+    // The slice mask greedy mesher the bitmask mesher replaced, merging faces per direction and voxel id and
+    //   stopping at mesh section borders the same way. Kept as the reference GenerateChunkMesh() is tested
+    //   and benchmarked against, lod 0 only.
+    VoxelMesh GenerateChunkMeshReference(const Chunk& chunk, const ChunkNeighbours& neighbours = ChunkNeighbours()) const;
+    void QueueChunkMesh(const ChunkID& chunk_id);
+    // Meshes and buffers edited chunks on the calling (render) thread, so an edit shows up in the frame it
+    //   was made rather than waiting behind generation jobs on the pool. Only the mesh sections holding edited
+    //   16^3 sections are rebuilt, unless the chunk is at a lower LOD or has a newer mesh in flight.
+    void RemeshEditedChunks(const std::vector<EditedChunk>& edited_chunks);
+    void UploadPendingMeshes();
+    void SetUploadBudget(size_t max_bytes, int max_meshes);
+    size_t GetPendingUploadCount();
+    MeshStats GetMeshStats() const;
+
+    struct ArenaStats
+    {
+        GpuAllocator::Stats vertices;
+        GpuAllocator::Stats indices;
+        size_t reused_in_place = 0;
+        size_t compaction_moves = 0;
+        // Vertices allocated past the end of each section's data to fill its last MESH_PAGE_VERTICES page
+        size_t page_padding_vertices = 0;
+    };
+    ArenaStats GetArenaStats() const;
+    const RenderStats& GetRenderStats() const;
+
+    // The last frame that had edits to remesh
+    struct EditStats
+    {
+        size_t chunks = 0;
+        // Mesh sections rebuilt and the bytes uploaded for them
+        size_t sections = 0;
+        size_t bytes = 0;
+        double milliseconds = 0.0;
+    };
+    const EditStats& GetLastEditStats() const;
+
+    struct MesherBenchmarkResult
+    {
+        bool valid = false;
+        size_t chunks = 0;
+        int repeats = 0;
+        size_t quads = 0;
+        size_t reference_quads = 0;
+        double seconds = 0.0;
+        double reference_seconds = 0.0;
+        // Chunks the two meshers produced different quads for
+        size_t mismatched_chunks = 0;
+    };
+    // Generates a block of chunks away from the loaded world and meshes each one repeats times with both
+    //   GenerateChunkMesh() and GenerateChunkMeshReference() on the calling thread
+    const MesherBenchmarkResult& RunMesherBenchmark(int chunks_per_axis = 4, int repeats = 4);
+    const MesherBenchmarkResult& GetLastMesherBenchmark() const;
+    void SetOcclusionCulling(bool enabled);
+    bool GetOcclusionCulling() const;
+    // Uploads the sections the mesh holds, reusing each section's ranges when the new data still fits
     void BufferVoxelMesh(const ChunkID& chunk_id, VoxelMesh& mesh);
     void DeleteVoxelMesh(const ChunkID& chunk_id);
     void RenderMesh(const ChunkID& chunk_id);
-    void RenderAllMeshes();
+    // Draws every buffered mesh section whose bounds intersect the view frustum in a single multi-draw
+    void RenderAllMeshes(const glm::mat4& view_projection);
     void FreeRenderMeshes();
 
     static const float voxelColors[256][3];
@@ -72,66 +221,267 @@ private:
     std::shared_ptr<Shader> m_voxel_shader = nullptr;
 
     GLuint VoxelRendererVAO = 0;
-    std::unordered_map<ChunkID, VoxelRenderBufferInfo> VoxelRendererBufferInfoMap;
+    // 256 x 1 texture of voxel colours, indexed by the voxel id in each vertex
+    GLuint m_palette_texture = 0;
+    ChunkMap<VoxelRenderBufferInfo> VoxelRendererBufferInfoMap;
+
+    // One GL buffer shared by every chunk mesh, with ranges handed out by a GpuAllocator. The buffer
+    //   doubles in size, keeping its contents, when nothing fits.
+    struct MeshArena
+    {
+        GLuint buffer = 0;
+        GLenum target = 0;
+        size_t element_size = 0;
+        GpuAllocator allocator;
+    };
+    MeshArena m_vertex_arena;
+    MeshArena m_index_arena;
+    size_t m_reused_in_place = 0;
+    size_t m_compaction_moves = 0;
+
+    // Arenas fragmented past this get a few allocations moved down every frame
+    static constexpr float COMPACTION_THRESHOLD = 0.25f;
+    static const size_t COMPACTION_BYTES_PER_FRAME = 1024 * 1024;
+
+    // Vertex allocations are made in pages, and every page records the origin of the chunk that owns it.
+    //   The vertex shader looks the origin up from gl_VertexID (which includes the base vertex), so a
+    //   single glMultiDrawElementsBaseVertex can draw every chunk without per-draw uniforms.
+    static const size_t MESH_PAGE_VERTICES = 256;
+    std::vector<glm::ivec4> m_page_origins;
+    GLuint m_page_origin_buffer = 0;
+    GLuint m_page_origin_texture = 0;
+
+    // Reused every frame to build the multi-draw arguments
+    std::vector<GLsizei> m_draw_counts;
+    std::vector<const void*> m_draw_offsets;
+    std::vector<GLint> m_draw_base_vertices;
+
+    // Meshes finished by worker threads, waiting to be uploaded on the render thread
+    std::mutex m_mesh_mutex;
+    struct CompletedMesh
+    {
+        ChunkID chunk_id;
+        uint64_t revision;
+        VoxelMesh mesh;
+    };
+    std::deque<CompletedMesh> m_completed_meshes;
+
+    // Latest mesh revision queued per chunk, older results still in flight are dropped on upload
+    ChunkMap<uint64_t> m_mesh_revisions;
+    uint64_t m_next_mesh_revision = 1;
+
+    Frustum m_frustum;
+    OcclusionCuller m_occlusion_culler;
+    bool m_occlusion_culling = true;
+    RenderStats m_render_stats;
+    EditStats m_last_edit_stats;
+    MesherBenchmarkResult m_last_mesher_benchmark;
+
+    // Per-frame limits for UploadPendingMeshes()
+    size_t m_upload_budget_bytes = 4 * 1024 * 1024;
+    int m_upload_budget_meshes = 8;
 
 
     static VoxelData m_voxelRegistry[256];
     static void init();
+    // The chunk's loaded neighbours, leaving out any at a different LOD
+    ChunkNeighbours mesh_neighbours(const ChunkID& chunk_id, int lod) const;
+    void create_palette_texture();
+    void bind_render_state();
+    // Walks the chunk graph from the camera, returns false if the walk couldn't start
+    bool run_occlusion_culling();
+    void create_mesh_arenas();
+    void create_arena(MeshArena& arena, GLenum target, size_t element_size, size_t capacity, size_t alignment);
+    // Resizes the allocation at offset in place when possible, otherwise frees it and allocates count
+    //   elements elsewhere, growing the arena if needed. Pass INVALID_OFFSET for a fresh allocation.
+    size_t arena_reallocate(MeshArena& arena, size_t offset, size_t count, ChunkID owner);
+    void arena_free(MeshArena& arena, size_t offset);
+    void arena_grow(MeshArena& arena, size_t min_capacity);
+    void compact_arena(MeshArena& arena, size_t max_bytes);
+    void assign_page_origins(size_t vtx_offset, const glm::ivec3& origin);
+    void upload_page_origins(size_t first_page, size_t page_count);
 };
 
 class Chunk
 {
 public:
     static const int CHUNK_SIZE = 64;
+    static const int SECTION_SIZE = 16;
+    static const int SECTIONS_PER_AXIS = CHUNK_SIZE / SECTION_SIZE;
+    // First byte of a serialized chunk: every section's palette storage, ChunkCodec runs, or ChunkCodec
+    //   runs with the LZ pass on top
+    static const uint8_t CHUNK_FORMAT_SECTIONS = 1;
+    static const uint8_t CHUNK_FORMAT_RUNS = 2;
+    static const uint8_t CHUNK_FORMAT_RUNS_LZ = 3;
 
     Chunk(ChunkID chunk_id, glm::ivec3 origin);
     void GenerateChunk();
     glm::ivec3 getOrigin();
-    inline void SetVoxel(glm::ivec3 pos, const uint8_t& vd);
+    ChunkID GetChunkID() const;
+    void SetVoxel(glm::ivec3 pos, const uint8_t& vd);
     uint8_t GetVoxel(glm::ivec3 pos) const;
+    // Get/SetVoxel without the range check, pos must already be inside 0..CHUNK_SIZE - 1
+    uint8_t GetVoxelUnchecked(glm::ivec3 pos) const;
+    void SetVoxelUnchecked(glm::ivec3 pos, uint8_t id);
+    // Copies the chunk-local box [min, max) to out, voxel min + (x, y, z) going to out[x * stride_x + y * stride_y + z]
+    void CopyRegion(glm::ivec3 min, glm::ivec3 max, uint8_t* out, size_t stride_x, size_t stride_y) const;
+    // Replaces every voxel, pos going from in[pos.x * CHUNK_SIZE * CHUNK_SIZE + pos.y * CHUNK_SIZE + pos.z]
+    void SetVoxels(const uint8_t* in);
+    // Sets every voxel to id
+    void Fill(uint8_t id);
+    size_t GetMemoryUsage() const;
+    // Hash of the voxel ids alone, the same however the chunk happens to be stored
+    uint64_t GetContentHash() const;
+
+    // Region file payload: the format byte, then for CHUNK_FORMAT_SECTIONS either one id for a uniform chunk or
+    //   every section's palette storage, otherwise the ChunkCodec encoding
+    void Serialize(std::vector<uint8_t>& out, uint8_t format = CHUNK_FORMAT_RUNS_LZ) const;
+    // Replaces the voxels with what Serialize wrote, in any format, and marks the chunk generated. Returns
+    //   false, leaving the chunk as it was, if the payload is malformed.
+    bool Deserialize(const uint8_t* data, size_t size);
+    // Set whenever the voxels change, cleared once they have been written out
+    bool IsDirty() const;
+    void ClearDirty();
+
+    bool IsUniform() const;
+    bool IsSectionUniform(glm::ivec3 section, uint8_t& id) const;
+    // Writes the section's SECTION_SIZE^3 voxel ids to out in x * 256 + y * 16 + z order
+    void CopySection(glm::ivec3 section, uint8_t* out) const;
+    // Replaces the section's voxels with SECTION_SIZE^3 ids in CopySection order
+    void SetSection(glm::ivec3 section, const uint8_t* in);
+    // Collapses sections (and then the whole chunk) that hold a single voxel id
+    void Optimize();
 
 private:
     bool m_generated = false;
+    bool m_dirty = false;
     ChunkID m_chunkID;
     glm::ivec3 m_origin;
-    std::vector<uint8_t> m_voxelArray;
+
+    // 16^3 sections indexed x * 16 + y * 4 + z, empty while the whole chunk is m_uniform_id
+    std::vector<PaletteStorage> m_sections;
+    uint8_t m_uniform_id = 0;
 };
 
 class MultiChunkSystem {
 public:
     MultiChunkSystem();
     void update();
+    std::vector<ChunkID> TakeChunksToMesh();
+    bool HasChunk(const ChunkID& chunk_id) const;
+    // Pointers stay valid until the chunk is evicted, which only happens inside update()
+    Chunk* GetChunk(const ChunkID& chunk_id) const;
+    ChunkHandle GetChunkHandle(const ChunkID& chunk_id) const;
+    // Null if the handle's chunk has been evicted since
+    Chunk* ResolveChunkHandle(const ChunkHandle& handle) const;
+    ChunkNeighbours GetNeighbours(const ChunkID& chunk_id) const;
+    ChunkNeighbourhood GetNeighbourhood(const ChunkID& chunk_id) const;
+    // True if the chunk index lies within the world's limits, WORLD_CHUNK_RADIUS around the origin on x/z and
+    //   WORLD_MIN_LAYER..WORLD_MAX_LAYER on y. Only these chunks are ever loaded, and indices outside them
+    //   may alias other chunks once packed, so lookups by index check this first.
+    static bool IsInWorld(const glm::ivec3& chunk_idx);
+    // Looks a loaded chunk up by chunk index (world position / CHUNK_SIZE)
+    bool FindChunk(const glm::ivec3& chunk_idx, ChunkID& chunk_id) const;
+    // Lowest and highest vertical chunk index currently streamed in around the camera
+    void GetLayerRange(int& min_layer, int& max_layer) const;
+
+    // Level of detail each loaded chunk is meshed at. Rings double in width: chunks within the LOD radius
+    //   are lod 0, within twice that lod 1, within four times lod 2, and everything further out MAX_LOD.
+    static const int MAX_LOD = 3;
+    int GetChunkLOD(const ChunkID& chunk_id) const;
+    void SetLODRadius(int radius);
+    int GetLODRadius() const;
+    std::array<size_t, MAX_LOD + 1> GetLODCounts() const;
 
-    glm::ivec2 pos_to_nearest_chunk_idx(glm::vec3 camera_position);
-    const std::unordered_map<ChunkID, std::shared_ptr<Chunk>>& get_chunk_map() const;
+    void SetChunkGenRadius(int radius);
+    int GetChunkGenRadius() const;
+    // Layers of chunks kept loaded above and below the camera's, within WORLD_MIN_LAYER..WORLD_MAX_LAYER
+    void SetVerticalRadius(int radius);
+    int GetVerticalRadius() const;
+    size_t GetTotalChunksLoaded() const;
+    size_t GetVoxelMemoryUsage() const;
+    // Records that the voxel at local_pos changed. Its section is marked, along with the sections (in this
+    //   chunk or a loaded neighbour) on the other side of any section border the voxel lies against, since
+    //   their faces depend on it. Many edits in one frame still remesh each chunk once.
+    void MarkVoxelEdited(const ChunkID& chunk_id, const glm::ivec3& local_pos);
+    // Chunks marked since the last call. They're also dropped from the regular mesh queue, since the
+    //   caller remeshes them right away; a chunk that was waiting there comes back with every section marked.
+    std::vector<EditedChunk> TakeEditedChunks();
+
+    // Queues every loaded chunk that changed since it was loaded (or was generated) with the ChunkIOService.
+    //   Evicted chunks are queued as they go, this is for shutdown.
+    void SaveAllChunks();
+
+    struct LoadedChunk
+    {
+        ChunkHandle handle;
+        Chunk* chunk = nullptr;
+        int lod = 0;
+    };
+
+    glm::ivec3 pos_to_nearest_chunk_idx(glm::vec3 camera_position);
+    const ChunkMap<LoadedChunk>& get_chunk_map() const;
     const glm::ivec3 GetChunkOrigin(const ChunkID& chunk_id);
 
     
 private:
-    static const int WORLD_CHUNK_RADIUS = 2048;
-    static const int CHUNK_HEIGHT = 1;
+    // Adds and removes chunks directly, to test handles against reused slots and World against known voxels,
+    //   and picks LODs with lod_for_chunk for the LOD ring benchmark
+    friend class TestRunner;
+
+    static constexpr int WORLD_CHUNK_RADIUS = 2048;
+    // Vertical limits of the world in chunks, y = -256 .. 512
+    static constexpr int WORLD_MIN_LAYER = -4;
+    static constexpr int WORLD_MAX_LAYER = 7;
+    // Neighbour lookups step one chunk past a loaded one with CHUNK_ID_STEP_*, which has to stay in the packed range
+    static_assert(WORLD_CHUNK_RADIUS + 1 < CHUNK_ID_AXIS_BIAS && -WORLD_MIN_LAYER + 1 < CHUNK_ID_AXIS_BIAS &&
+                  WORLD_MAX_LAYER + 1 < CHUNK_ID_AXIS_BIAS, "world limits exceed the packed ChunkID range");
 
     int m_chunk_gen_radius = 4;
+    int m_vertical_radius = 2;
+    // Chunks are only evicted once they are this many chunks past m_chunk_gen_radius (or m_vertical_radius)
+    int m_evict_hysteresis = 2;
+    glm::ivec3 m_center_idx = glm::ivec3(0);
+    size_t m_total_chunks_loaded = 0;
 
-    std::unordered_map<ChunkID, std::shared_ptr<Chunk>> m_chunk_list;
-    std::vector<std::shared_ptr<Chunk>> loaded_chunks;
+    ChunkMap<LoadedChunk> m_chunk_list;
+    // Owns the loaded chunks. Evicted slots go on the free list and bump their generation.
+    std::vector<std::unique_ptr<Chunk>> m_chunk_slots;
+    std::vector<uint32_t> m_chunk_generations;
+    std::vector<uint32_t> m_free_chunk_slots;
 
-    glm::ivec2 chunk_idx_to_origin(glm::ivec2 chunk_idx);
-    inline ChunkID chunk_idx_id(glm::ivec2 chunk_idx);
-};
+    int m_lod_radius = 4;
+    // Centre the LODs were last assigned around, they only change when this does
+    glm::ivec3 m_lod_center = glm::ivec3(0);
+    bool m_lod_center_valid = false;
 
-class NoiseGenerator
-{
-public:
-    NoiseGenerator();
-    
-    FastNoiseLite GetNoise();
+    // Chunks queued on the thread pool but not yet picked up by update()
+    ChunkSet m_pending_chunks;
+    // Chunks whose mesh is out of date since the last TakeChunksToMesh(): new chunks and the loaded
+    //   neighbours of chunks that were added or evicted, since their border faces depend on each other
+    ChunkSet m_chunks_to_mesh;
+    // Edited sections per chunk since the last TakeEditedChunks()
+    ChunkMap<uint64_t> m_edited_sections;
 
-private:
-    int m_seed = 6;
-    float m_freq = 0.2f;
-    FastNoiseLite m_noise;
-    
+    // Filled by worker threads, drained by update() on the main thread
+    std::mutex m_generated_mutex;
+    std::vector<std::unique_ptr<Chunk>> m_generated_chunks;
+
+    void queue_chunk(glm::ivec3 chunk_idx);
+    void collect_generated_chunks(glm::ivec3 center_idx);
+    void evict_far_chunks(glm::ivec3 center_idx);
+    ChunkHandle add_chunk(std::unique_ptr<Chunk> chunk);
+    // Hands back the removed chunk, null if it wasn't loaded
+    std::unique_ptr<Chunk> remove_chunk(const ChunkID& chunk_id);
+    bool chunk_outside_radius(glm::ivec3 chunk_idx, glm::ivec3 center_idx, int radius, int vertical_radius);
+    void layer_range(glm::ivec3 center_idx, int vertical_radius, int& min_layer, int& max_layer) const;
+
+    glm::ivec3 chunk_idx_to_origin(glm::ivec3 chunk_idx);
+    void mark_neighbours_to_mesh(const ChunkID& chunk_id);
+    // Marks the section, stepping into the neighbouring chunk when it lies one past the edge of this one
+    void mark_section_edited(const ChunkID& chunk_id, glm::ivec3 section);
+    int lod_for_chunk(glm::ivec3 chunk_idx, glm::ivec3 center_idx) const;
+    void update_chunk_lods(glm::ivec3 center_idx);
 };
 
 #endif
\ No newline at end of file
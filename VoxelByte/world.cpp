@@ -0,0 +1,237 @@
+#include "globals.h"
+
+#include <limits>
+
+// Chunk coordinates are found with shifts and masks, which round towards negative infinity as needed
+static_assert((Chunk::CHUNK_SIZE & (Chunk::CHUNK_SIZE - 1)) == 0, "CHUNK_SIZE must be a power of two");
+static const int CHUNK_SHIFT = std::countr_zero(static_cast<unsigned int>(Chunk::CHUNK_SIZE));
+static const int CHUNK_MASK = Chunk::CHUNK_SIZE - 1;
+
+// ----------<[ WORLD CLASS IMPLEMENTATION ]>----------
+World::World()
+    : m_chunk_system(VB::inst().GetMultiChunkSystem().get())
+{
+    VB::inst().GetLogger()->Print("World obj constructed");
+}
+
+uint8_t World::GetVoxel(const glm::ivec3& world_pos, uint8_t unloaded_id) const
+{
+    Chunk* chunk = find_chunk(WorldToChunkIdx(world_pos));
+    if (chunk == nullptr) return unloaded_id;
+    return chunk->GetVoxelUnchecked(WorldToLocal(world_pos));
+}
+
+bool World::SetVoxel(const glm::ivec3& world_pos, uint8_t id)
+{
+    Chunk* chunk = find_chunk(WorldToChunkIdx(world_pos));
+    if (chunk == nullptr) return false;
+
+    chunk->SetVoxelUnchecked(WorldToLocal(world_pos), id);
+    return true;
+}
+
+bool World::IsLoaded(const glm::ivec3& world_pos) const
+{
+    return find_chunk(WorldToChunkIdx(world_pos)) != nullptr;
+}
+
+bool World::EditVoxel(const glm::ivec3& world_pos, uint8_t id)
+{
+    Chunk* chunk = find_chunk(WorldToChunkIdx(world_pos));
+    if (chunk == nullptr) return false;
+
+    glm::ivec3 local = WorldToLocal(world_pos);
+    if (chunk->GetVoxelUnchecked(local) == id) return false;
+
+    chunk->SetVoxelUnchecked(local, id);
+    m_chunk_system->MarkVoxelEdited(chunk->GetChunkID(), local);
+    return true;
+}
+
+bool World::Raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, RaycastHit& hit) const
+{
+    float length = glm::length(direction);
+    if (length <= 0.0f) return false;
+    glm::vec3 dir = direction / length;
+
+    // Amanatides & Woo: t_max is the distance along the ray to the next boundary on each axis, t_delta the
+    //   distance between boundaries. Every step crosses whichever boundary comes first.
+    glm::ivec3 voxel(glm::floor(origin));
+    glm::ivec3 step;
+    glm::vec3 t_max;
+    glm::vec3 t_delta;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        step[axis] = dir[axis] > 0.0f ? 1 : -1;
+        if (dir[axis] == 0.0f)
+        {
+            t_max[axis] = std::numeric_limits<float>::infinity();
+            t_delta[axis] = std::numeric_limits<float>::infinity();
+            continue;
+        }
+
+        float boundary = dir[axis] > 0.0f ? voxel[axis] + 1.0f : static_cast<float>(voxel[axis]);
+        t_max[axis] = (boundary - origin[axis]) / dir[axis];
+        t_delta[axis] = std::abs(1.0f / dir[axis]);
+    }
+
+    glm::ivec3 normal(0);
+    float distance = 0.0f;
+    while (distance <= max_distance)
+    {
+        uint8_t id = GetVoxel(voxel);
+        if (VoxelRenderer::GetVoxelData(id).solid)
+        {
+            hit.position = voxel;
+            hit.normal = normal;
+            hit.id = id;
+            hit.distance = distance;
+            return true;
+        }
+
+        int axis = t_max.x < t_max.y ? (t_max.x < t_max.z ? 0 : 2) : (t_max.y < t_max.z ? 1 : 2);
+        distance = t_max[axis];
+        t_max[axis] += t_delta[axis];
+        voxel[axis] += step[axis];
+        normal = glm::ivec3(0);
+        normal[axis] = -step[axis];
+    }
+
+    return false;
+}
+
+void World::ReadRegion(const glm::ivec3& min, const glm::ivec3& max, uint8_t* out, uint8_t unloaded_id) const
+{
+    if (glm::any(glm::greaterThanEqual(min, max))) return;
+
+    glm::ivec3 size = max - min;
+    size_t stride_x = static_cast<size_t>(size.y) * size.z;
+    size_t stride_y = static_cast<size_t>(size.z);
+
+    glm::ivec3 first_chunk = WorldToChunkIdx(min);
+    glm::ivec3 last_chunk = WorldToChunkIdx(max - 1);
+    for (int cx = first_chunk.x; cx <= last_chunk.x; cx++)
+    for (int cy = first_chunk.y; cy <= last_chunk.y; cy++)
+    for (int cz = first_chunk.z; cz <= last_chunk.z; cz++)
+    {
+        glm::ivec3 chunk_idx(cx, cy, cz);
+        glm::ivec3 chunk_origin = chunk_idx * Chunk::CHUNK_SIZE;
+        glm::ivec3 box_min = glm::max(min, chunk_origin);
+        glm::ivec3 box_max = glm::min(max, chunk_origin + Chunk::CHUNK_SIZE);
+        uint8_t* box_out = out + (box_min.x - min.x) * stride_x + (box_min.y - min.y) * stride_y + (box_min.z - min.z);
+
+        const Chunk* chunk = MultiChunkSystem::IsInWorld(chunk_idx) ? m_chunk_system->GetChunk(PackChunkID(chunk_idx)) : nullptr;
+        if (chunk != nullptr)
+        {
+            chunk->CopyRegion(box_min - chunk_origin, box_max - chunk_origin, box_out, stride_x, stride_y);
+            continue;
+        }
+
+        for (int x = 0; x < box_max.x - box_min.x; x++)
+            for (int y = 0; y < box_max.y - box_min.y; y++)
+            {
+                uint8_t* row = box_out + x * stride_x + y * stride_y;
+                std::fill(row, row + (box_max.z - box_min.z), unloaded_id);
+            }
+    }
+}
+
+World::RegionIterator World::IterateRegion(const glm::ivec3& min, const glm::ivec3& max) const
+{
+    return RegionIterator(this, min, max);
+}
+
+glm::ivec3 World::WorldToChunkIdx(const glm::ivec3& world_pos)
+{
+    return glm::ivec3(world_pos.x >> CHUNK_SHIFT, world_pos.y >> CHUNK_SHIFT, world_pos.z >> CHUNK_SHIFT);
+}
+
+glm::ivec3 World::WorldToLocal(const glm::ivec3& world_pos)
+{
+    return glm::ivec3(world_pos.x & CHUNK_MASK, world_pos.y & CHUNK_MASK, world_pos.z & CHUNK_MASK);
+}
+
+Chunk* World::find_chunk(const glm::ivec3& chunk_idx) const
+{
+    // Far enough out, the packed ID would alias a loaded chunk
+    if (!MultiChunkSystem::IsInWorld(chunk_idx)) return nullptr;
+
+    ChunkID chunk_id = PackChunkID(chunk_idx);
+    if (chunk_id == m_cached_id)
+    {
+        Chunk* chunk = m_chunk_system->ResolveChunkHandle(m_cached_handle);
+        if (chunk != nullptr) return chunk;
+    }
+
+    m_cached_id = chunk_id;
+    m_cached_handle = m_chunk_system->GetChunkHandle(chunk_id);
+    return m_chunk_system->ResolveChunkHandle(m_cached_handle);
+}
+
+// ----------<[ REGIONITERATOR CLASS IMPLEMENTATION ]>----------
+World::RegionIterator::RegionIterator(const World* world, const glm::ivec3& min, const glm::ivec3& max)
+    : m_world(world), m_min(min), m_max(max), m_pos(min)
+{
+    // An empty box starts out past the end
+    if (glm::any(glm::greaterThanEqual(min, max))) m_pos.x = max.x;
+    else enter_chunk();
+}
+
+bool World::RegionIterator::IsValid() const
+{
+    return m_pos.x < m_max.x;
+}
+
+void World::RegionIterator::Next()
+{
+    m_pos.z++;
+    m_local.z++;
+    if (m_pos.z < m_max.z && m_local.z < Chunk::CHUNK_SIZE) return;
+
+    if (m_pos.z >= m_max.z)
+    {
+        m_pos.z = m_min.z;
+        if (++m_pos.y >= m_max.y)
+        {
+            m_pos.y = m_min.y;
+            if (++m_pos.x >= m_max.x) return;
+        }
+    }
+    enter_chunk();
+}
+
+const glm::ivec3& World::RegionIterator::GetPosition() const
+{
+    return m_pos;
+}
+
+Chunk* World::RegionIterator::GetChunk() const
+{
+    return m_chunk;
+}
+
+uint8_t World::RegionIterator::GetVoxel(uint8_t unloaded_id) const
+{
+    if (m_chunk == nullptr) return unloaded_id;
+    return m_chunk->GetVoxelUnchecked(m_local);
+}
+
+bool World::RegionIterator::SetVoxel(uint8_t id)
+{
+    if (m_chunk == nullptr) return false;
+
+    m_chunk->SetVoxelUnchecked(m_local, id);
+    return true;
+}
+
+void World::RegionIterator::enter_chunk()
+{
+    m_local = WorldToLocal(m_pos);
+
+    glm::ivec3 chunk_idx = WorldToChunkIdx(m_pos);
+    if (m_chunk_looked_up && chunk_idx == m_chunk_idx) return;
+
+    m_chunk_idx = chunk_idx;
+    m_chunk_looked_up = true;
+    m_chunk = MultiChunkSystem::IsInWorld(chunk_idx) ? m_world->m_chunk_system->GetChunk(PackChunkID(chunk_idx)) : nullptr;
+}
@@ -0,0 +1,87 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "voxel.h"
+
+// Voxel access in world coordinates, across chunk boundaries. Positions that aren't in a loaded chunk
+//   read as unloaded_id (air by default) and ignore writes. SetVoxel doesn't queue a remesh, EditVoxel does.
+//   Main thread only: it reads the chunk list, which MultiChunkSystem::update() changes.
+class World
+{
+public:
+    World();
+
+    uint8_t GetVoxel(const glm::ivec3& world_pos, uint8_t unloaded_id = 0) const;
+    // Returns false if the position isn't loaded
+    bool SetVoxel(const glm::ivec3& world_pos, uint8_t id);
+    bool IsLoaded(const glm::ivec3& world_pos) const;
+    // SetVoxel for gameplay edits: the sections touched are marked with MultiChunkSystem::MarkVoxelEdited,
+    //   so the chunk (and any neighbour sharing the changed faces) is remeshed once at the end of the frame.
+    //   Returns false if the position isn't loaded or already holds id.
+    bool EditVoxel(const glm::ivec3& world_pos, uint8_t id);
+
+    struct RaycastHit
+    {
+        // The solid voxel hit and the face the ray entered it through, position + normal is the voxel in front
+        glm::ivec3 position;
+        glm::ivec3 normal;
+        uint8_t id;
+        float distance;
+    };
+    // Steps through the voxels the ray passes (voxel p spans [p, p + 1)) one boundary at a time and reports
+    //   the first solid one within max_distance. Unloaded voxels count as air.
+    bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, RaycastHit& hit) const;
+
+    // Copies the box [min, max) into out, voxel min + (x, y, z) going to out[(x * size.y + y) * size.z + z]
+    //   with size = max - min. Each chunk the box overlaps is looked up once.
+    void ReadRegion(const glm::ivec3& min, const glm::ivec3& max, uint8_t* out, uint8_t unloaded_id = 0) const;
+
+    // Visits every voxel of the box [min, max) in x, y, z order (z fastest), only looking the chunk up
+    //   again when the walk crosses into a new one
+    class RegionIterator
+    {
+    public:
+        bool IsValid() const;
+        void Next();
+
+        const glm::ivec3& GetPosition() const;
+        // Null where nothing is loaded
+        Chunk* GetChunk() const;
+        uint8_t GetVoxel(uint8_t unloaded_id = 0) const;
+        bool SetVoxel(uint8_t id);
+
+    private:
+        friend class World;
+        RegionIterator(const World* world, const glm::ivec3& min, const glm::ivec3& max);
+
+        const World* m_world;
+        glm::ivec3 m_min;
+        glm::ivec3 m_max;
+        glm::ivec3 m_pos;
+        glm::ivec3 m_local;
+        glm::ivec3 m_chunk_idx;
+        Chunk* m_chunk = nullptr;
+        // m_chunk holds the lookup for m_chunk_idx, null included, so rows through an unloaded chunk
+        //   don't repeat it
+        bool m_chunk_looked_up = false;
+
+        void enter_chunk();
+    };
+    RegionIterator IterateRegion(const glm::ivec3& min, const glm::ivec3& max) const;
+
+    // Chunk index containing a world position, and the position inside that chunk
+    static glm::ivec3 WorldToChunkIdx(const glm::ivec3& world_pos);
+    static glm::ivec3 WorldToLocal(const glm::ivec3& world_pos);
+
+private:
+    MultiChunkSystem* m_chunk_system;
+
+    // Last chunk looked up by GetVoxel / SetVoxel. Runs of nearby accesses skip the hash lookup, and the
+    //   handle goes stale by itself if the chunk is evicted.
+    mutable ChunkID m_cached_id = ChunkMap<ChunkHandle>::EMPTY_KEY;
+    mutable ChunkHandle m_cached_handle;
+
+    Chunk* find_chunk(const glm::ivec3& chunk_idx) const;
+};
+
+#endif
@@ -3,7 +3,7 @@
 @set OUT_EXE=VoxelByte
 @set INCLUDES=-I include/
 @set SOURCES=include/imgui/imgui.cpp include/imgui/imgui_draw.cpp include/imgui/imgui_impl_glfw.cpp include/imgui/imgui_impl_opengl3.cpp include/imgui/imgui_tables.cpp include/imgui/imgui_widgets.cpp include/glad/glad.c VoxelByte/*
-@set LIBS=-lopengl32 -lgdi32 -lglu32 -ldwmapi -L binaries -lglfw3
+@set LIBS=-lopengl32 -lgdi32 -lglu32 -ldwmapi -lpsapi -L binaries -lglfw3
 mkdir %OUT_DIR%
-g++ -DUNICODE %INCLUDES% %SOURCES% -g -o %OUT_DIR%/%OUT_EXE%.exe -mwindows -mconsole --static %LIBS%
+g++ -std=c++20 -DUNICODE %INCLUDES% %SOURCES% -g -o %OUT_DIR%/%OUT_EXE%.exe -mwindows -mconsole --static %LIBS%
 pause
\ No newline at end of file
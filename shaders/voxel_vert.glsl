@@ -1,7 +1,7 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
+// x, y, z (7 bits each), face (3 bits), voxel id (8 bits)
+layout (location = 0) in uint aData;
 
 out vec3 frag_color;
 out vec3 normal;
@@ -9,10 +9,26 @@ out vec3 normal;
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
-uniform vec3 pos_offset;
+uniform sampler1D voxel_palette;
+// Origin of the chunk owning each 256-vertex page of the shared vertex buffer
+uniform isamplerBuffer chunk_origins;
+
+const vec3 face_normals[6] = vec3[6](
+    vec3( 1.0,  0.0,  0.0), vec3(-1.0,  0.0,  0.0),
+    vec3( 0.0,  1.0,  0.0), vec3( 0.0, -1.0,  0.0),
+    vec3( 0.0,  0.0,  1.0), vec3( 0.0,  0.0, -1.0)
+);
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos + pos_offset, 1.0);
-    frag_color = aColor;
-}
\ No newline at end of file
+    vec3 aPos = vec3(float(aData & 127u), float((aData >> 7u) & 127u), float((aData >> 14u) & 127u));
+    uint face = (aData >> 21u) & 7u;
+    int voxel_id = int(aData >> 24u);
+
+    // gl_VertexID includes the draw's base vertex, so it addresses the shared buffer directly
+    vec3 chunk_origin = vec3(texelFetch(chunk_origins, gl_VertexID / 256).xyz);
+
+    gl_Position = projection * view * model * vec4(aPos + chunk_origin, 1.0);
+    frag_color = texelFetch(voxel_palette, voxel_id, 0).rgb;
+    normal = face_normals[face];
+}